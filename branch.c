@@ -0,0 +1,228 @@
+/* Branch and Bound Solver
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "lalgebra.h"
+#include "branch.h"
+
+// Constant to solve floating point comparisons
+#define EPSILON 0.000001
+
+// Workers taking nodes from the pool at the same time
+#define NUM_WORKERS 4
+
+static void free_node(struct node* node) {
+  free_matrix(node->lp, node->m);
+  free(node->base);
+  free(node);
+}
+
+// Must be called with the lock held
+static void push_node(struct branch_and_bound* bb, struct node* node) {
+  if(bb->count == bb->capacity) {
+    bb->capacity *= 2;
+    bb->nodes = realloc(bb->nodes, bb->capacity * sizeof(struct node*));
+  }
+  bb->nodes[bb->count] = node;
+  bb->count++;
+
+  pthread_cond_broadcast(&bb->changed);
+}
+
+// Removes the next node according to the selection rule. Must be called with the lock held
+static struct node* pop_node(struct branch_and_bound* bb) {
+  struct node* node;
+  int i, chosen;
+
+  chosen = bb->count - 1; // Depth first takes the last node added
+
+  if(bb->selection == 'M') { // Best first takes the node with the highest objective value
+    for(i = 0; i < bb->count; i++) {
+      if(bb->nodes[i]->lp[0][bb->nodes[i]->n - 1] > bb->nodes[chosen]->lp[0][bb->nodes[chosen]->n - 1]) {
+        chosen = i;
+      }
+    }
+  }
+
+  node = bb->nodes[chosen];
+  bb->nodes[chosen] = bb->nodes[bb->count - 1];
+  bb->count--;
+
+  return node;
+}
+
+// A node can only lead to a better solution if its bound is above the best one found so far
+static int is_promising(struct branch_and_bound* bb, struct node* node) {
+  int promising;
+
+  pthread_mutex_lock(&bb->lock);
+  promising = !bb->found || node->lp[0][node->n - 1] > (bb->best_value + EPSILON);
+  pthread_mutex_unlock(&bb->lock);
+
+  return promising;
+}
+
+// Adds the restriction sign * x_column <= bound to the parent's tableau and reoptimizes with the dual simplex.
+// The parent's base stays dual feasible, so only a few pivots are needed. Returns NULL if the child is infeasible
+static struct node* create_child(struct node* parent, int column, double sign, double bound) {
+  struct node* child;
+  int i;
+
+  child = malloc(sizeof(struct node));
+  child->m = parent->m + 1;
+  child->n = parent->n + 2;
+  child->lp = add_bound_row(parent->lp, parent->m, parent->n, column, sign, bound);
+
+  // Every column after the operations register moved one position and the new slack is the base of the new row
+  child->base = malloc((child->m - 1) * sizeof(int));
+  for(i = 0; i < (parent->m - 1); i++) {
+    child->base[i] = parent->base[i] + 1;
+  }
+  child->base[child->m - 2] = parent->n;
+
+  if(dual_simplex(child->lp, child->m, child->n, child->base, 0, NULL) != -1) {
+    free_node(child);
+    return NULL;
+  }
+
+  return child;
+}
+
+// Branches on the integer variable whose value is the most fractional one. If there is none, the node's
+// solution is integer and becomes the best one if it beats the current best
+static void process_node(struct branch_and_bound* bb, struct node* node) {
+  struct node* children[2];
+  double* solution;
+  double fraction, best_fraction;
+  int j, k, column;
+
+  if(!is_promising(bb, node)) {
+    free_node(node);
+    return;
+  }
+
+  solution = get_primal_optimal_solution(node->lp, node->m, node->n, node->base);
+
+  column = -1;
+  best_fraction = EPSILON;
+  for(j = 0; j < bb->variables; j++) {
+    fraction = fabs(solution[j] - round(solution[j]));
+    if(bb->integer[j] && fraction > best_fraction) {
+      best_fraction = fraction;
+      column = j;
+    }
+  }
+
+  if(column == -1) { // Integer solution
+    pthread_mutex_lock(&bb->lock);
+    if(!bb->found || node->lp[0][node->n - 1] > bb->best_value) {
+      bb->found = 1;
+      bb->best_value = node->lp[0][node->n - 1];
+      for(j = 0; j < bb->variables; j++) {
+        bb->best_solution[j] = round(solution[j] * 100000) / 100000;
+      }
+    }
+    pthread_mutex_unlock(&bb->lock);
+  }
+  else { // x <= floor(value) and -x <= -ceil(value)
+    children[0] = create_child(node, (column + (node->m - 1)), 1, floor(solution[column]));
+    children[1] = create_child(node, (column + (node->m - 1)), -1, -1 * ceil(solution[column]));
+
+    for(k = 0; k < 2; k++) {
+      if(children[k] != NULL) {
+        if(is_promising(bb, children[k])) {
+          pthread_mutex_lock(&bb->lock);
+          push_node(bb, children[k]);
+          pthread_mutex_unlock(&bb->lock);
+        }
+        else {
+          free_node(children[k]);
+        }
+      }
+    }
+  }
+
+  free(solution);
+  free_node(node);
+}
+
+// Takes nodes from the pool until it is empty and no other worker can add more nodes to it
+static void* worker(void* arg) {
+  struct branch_and_bound* bb = arg;
+  struct node* node;
+
+  while(1) {
+    pthread_mutex_lock(&bb->lock);
+    while(bb->count == 0 && bb->active > 0) {
+      pthread_cond_wait(&bb->changed, &bb->lock);
+    }
+    if(bb->count == 0) { // Search is over
+      pthread_mutex_unlock(&bb->lock);
+      return NULL;
+    }
+    node = pop_node(bb);
+    bb->active++;
+    pthread_mutex_unlock(&bb->lock);
+
+    process_node(bb, node);
+
+    pthread_mutex_lock(&bb->lock);
+    bb->active--;
+    pthread_cond_broadcast(&bb->changed);
+    pthread_mutex_unlock(&bb->lock);
+  }
+}
+
+// Finds the best solution where the marked variables are integer. lp and base must hold the optimal tableau of the
+// LP relaxation, which is copied to the root node and not modified. The value and the variables of the best
+// solution are written to value and solution. Returns 1 if there is an integer solution and 0 otherwise
+int branch_and_bound(double** lp, int m, int n, int* base, int* integer, char selection, double* value, double* solution) {
+  struct branch_and_bound bb;
+  struct node* root;
+  pthread_t threads[NUM_WORKERS];
+  int i;
+
+  root = malloc(sizeof(struct node));
+  root->m = m;
+  root->n = n;
+  root->lp = allocate_matrix(m, n);
+  copy_matrix(lp, root->lp, m, n);
+  root->base = malloc((m - 1) * sizeof(int));
+  for(i = 0; i < (m - 1); i++) {
+    root->base[i] = base[i];
+  }
+
+  bb.capacity = 16;
+  bb.nodes = malloc(bb.capacity * sizeof(struct node*));
+  bb.count = 0;
+  bb.active = 0;
+  bb.selection = selection;
+  bb.integer = integer;
+  bb.variables = n - 1 - (m - 1) - (m - 1);
+  bb.found = 0;
+  bb.best_value = 0;
+  bb.best_solution = solution;
+  pthread_mutex_init(&bb.lock, NULL);
+  pthread_cond_init(&bb.changed, NULL);
+
+  push_node(&bb, root);
+
+  for(i = 0; i < NUM_WORKERS; i++) {
+    pthread_create(&threads[i], NULL, worker, &bb);
+  }
+  for(i = 0; i < NUM_WORKERS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  *value = bb.best_value;
+
+  pthread_mutex_destroy(&bb.lock);
+  pthread_cond_destroy(&bb.changed);
+  free(bb.nodes);
+
+  return bb.found;
+}
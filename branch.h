@@ -0,0 +1,36 @@
+/* Branch and Bound Solver
+ */
+
+#ifndef __BRANCH_HEADER__
+#define __BRANCH_HEADER__
+
+#include <pthread.h>
+
+// Subproblem of the branch and bound. Its tableau is optimal for the LP relaxation with the bound rows
+// of every branch taken from the root to it
+struct node {
+  double** lp;
+  int m;
+  int n;
+  int* base;
+};
+
+// Pool of open nodes shared by the workers, and the best integer solution found so far
+struct branch_and_bound {
+  struct node** nodes;
+  int count;
+  int capacity;
+  int active; // Workers processing a node. The search ends when this is 0 and the pool is empty
+  char selection; // 'M' picks the node with the best bound, 'P' the last node added (depth first)
+  int* integer; // 1 for the variables that must be integer
+  int variables;
+  int found;
+  double best_value;
+  double* best_solution;
+  pthread_mutex_t lock;
+  pthread_cond_t changed;
+};
+
+int branch_and_bound(double** lp, int m, int n, int* base, int* integer, char selection, double* value, double* solution);
+
+#endif
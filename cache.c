@@ -0,0 +1,378 @@
+/* Result Cache
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "cache.h"
+
+// Constants of the 64 bit FNV-1a hash
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+// Most entries the cache file keeps. The oldest ones are dropped when a new one is saved
+#define MAX_CACHE_ENTRIES 1000
+
+/***** HASHING ******/
+
+// Feeds the bytes to FNV-1a and to sdbm, which don't share any constant or operation
+static void hash_bytes(struct lp_hash* hash, void* data, int size) {
+  unsigned char* bytes = data;
+  int i;
+
+  for(i = 0; i < size; i++) {
+    hash->fnv ^= bytes[i];
+    hash->fnv *= FNV_PRIME;
+    hash->sdbm = bytes[i] + (hash->sdbm << 6) + (hash->sdbm << 16) - hash->sdbm;
+  }
+}
+
+// -0 is turned into 0 so that equal LPs always have the same hash
+static void hash_value(struct lp_hash* hash, double value) {
+  if(value == 0) {
+    value = 0;
+  }
+
+  hash_bytes(hash, &value, sizeof(double));
+}
+
+static int same_hash(struct lp_hash* first, struct lp_hash* second) {
+  return first->fnv == second->fnv && first->sdbm == second->sdbm;
+}
+
+// Fills the key of the LP as it was read, before the slacks and the register are added. The structure hash
+// covers the dimensions and A, and the problem hash covers the structure, the mode, the whole first row
+// (c and the constant of the objective) and b
+void hash_lp(double** matrix, int m, int n, int mode, struct lp_key* key) {
+  int i, j;
+
+  key->m = m;
+  key->n = n;
+
+  key->structure.fnv = FNV_OFFSET;
+  key->structure.sdbm = 0;
+  hash_bytes(&key->structure, &m, sizeof(int));
+  hash_bytes(&key->structure, &n, sizeof(int));
+  for(i = 1; i < m; i++) {
+    for(j = 0; j < (n - 1); j++) {
+      hash_value(&key->structure, matrix[i][j]);
+    }
+  }
+
+  key->problem = key->structure;
+  hash_bytes(&key->problem, &mode, sizeof(int));
+  for(j = 0; j < n; j++) {
+    hash_value(&key->problem, matrix[0][j]);
+  }
+  for(i = 1; i < m; i++) {
+    hash_value(&key->problem, matrix[i][n - 1]);
+  }
+}
+
+static int same_problem(struct lp_key* first, struct lp_key* second) {
+  return first->m == second->m && first->n == second->n && same_hash(&first->problem, &second->problem);
+}
+
+static int same_structure(struct lp_key* first, struct lp_key* second) {
+  return first->m == second->m && first->n == second->n && same_hash(&first->structure, &second->structure);
+}
+
+/***** CACHE FILE ******/
+
+// Each of these reads the next field of the line and moves the cursor past it. They return 0 if the field
+// is missing, which happens when the line was cut
+static int read_hash(char** cursor, unsigned long long* value) {
+  char* end;
+
+  *value = strtoull(*cursor, &end, 10);
+  if(end == *cursor) {
+    return 0;
+  }
+  *cursor = end;
+
+  return 1;
+}
+
+static int read_int(char** cursor, int* value) {
+  char* end;
+
+  *value = strtol(*cursor, &end, 10);
+  if(end == *cursor) {
+    return 0;
+  }
+  *cursor = end;
+
+  return 1;
+}
+
+static int read_double(char** cursor, double* value) {
+  char* end;
+
+  *value = strtod(*cursor, &end);
+  if(end == *cursor) {
+    return 0;
+  }
+  *cursor = end;
+
+  return 1;
+}
+
+static int read_status(char** cursor, char* value) {
+  while(isspace(**cursor)) {
+    (*cursor)++;
+  }
+  if(**cursor != 'O' && **cursor != 'I' && **cursor != 'U') {
+    return 0;
+  }
+  *value = **cursor;
+  (*cursor)++;
+
+  return 1;
+}
+
+// Parses the start of one line of the file: dimensions and both hashes of the problem and of the structure.
+// Returns 0 if the line was cut, like the last one of a process killed while it was appending. cursor is left
+// after the key
+static int parse_key(char* line, struct lp_key* key, char** cursor) {
+  // The line break is the last thing written, so a line without it was cut
+  if(line[strlen(line) - 1] != '\n') {
+    return 0;
+  }
+
+  *cursor = line;
+  if(!read_int(cursor, &key->m) || !read_int(cursor, &key->n) || key->m < 1 || key->n < 1 ||
+      !read_hash(cursor, &key->problem.fnv) || !read_hash(cursor, &key->problem.sdbm) ||
+      !read_hash(cursor, &key->structure.fnv) || !read_hash(cursor, &key->structure.sdbm)) {
+    return 0;
+  }
+
+  return (size_t) (key->m + key->n) <= strlen(line); // Every field takes at least two characters
+}
+
+// Parses one whole line of the file: the key, status, value, x, y and the base. Vectors that the status
+// doesn't use are written as zeros and the base as -1. Returns NULL if the line is not a whole entry
+static struct lp_result* parse_result(char* line, struct lp_key* key) {
+  struct lp_result* result;
+  char* cursor;
+  int i, complete;
+
+  if(!parse_key(line, key, &cursor)) {
+    return NULL;
+  }
+
+  result = malloc(sizeof(struct lp_result));
+  result->variables = key->n - 1;
+  result->restrictions = key->m - 1;
+  result->x = malloc(result->variables * sizeof(double));
+  result->y = malloc(result->restrictions * sizeof(double));
+  result->base = malloc(result->restrictions * sizeof(int));
+
+  complete = read_status(&cursor, &result->status) && read_double(&cursor, &result->value);
+  for(i = 0; complete && i < result->variables; i++) {
+    complete = read_double(&cursor, &result->x[i]);
+  }
+  for(i = 0; complete && i < result->restrictions; i++) {
+    complete = read_double(&cursor, &result->y[i]);
+  }
+  for(i = 0; complete && i < result->restrictions; i++) {
+    complete = read_int(&cursor, &result->base[i]);
+  }
+  while(complete && isspace(*cursor)) {
+    cursor++;
+  }
+
+  if(!complete || *cursor != '\0') { // Missing or extra fields
+    free_lp_result(result);
+    return NULL;
+  }
+
+  if(result->status != 'O') {
+    free(result->base);
+    result->base = NULL;
+  }
+
+  return result;
+}
+
+// Reads the entry of the cache file with the same A as key, which is the only one that can be used for this LP.
+// The file keeps at most one entry for each A, so the search stops at the first one. A missing file is an
+// empty cache
+struct cache_entry* load_cache(char* file_name, struct lp_key* key) {
+  struct cache_entry* cache;
+  struct lp_result* result;
+  struct lp_key line_key;
+  char* line;
+  char* cursor;
+  size_t size;
+  FILE* file;
+
+  cache = NULL;
+
+  file = fopen(file_name, "r");
+  if(file == NULL) {
+    return NULL;
+  }
+
+  line = NULL;
+  size = 0;
+  while(getline(&line, &size, file) != -1) {
+    // Only the key is parsed until the entry is found
+    if(!parse_key(line, &line_key, &cursor) || !same_structure(&line_key, key)) {
+      continue;
+    }
+    result = parse_result(line, &line_key);
+    if(result != NULL) {
+      cache = malloc(sizeof(struct cache_entry));
+      cache->key = line_key;
+      cache->result = result;
+      cache->next = NULL;
+      break;
+    }
+  }
+
+  free(line);
+  fclose(file);
+
+  return cache;
+}
+
+void free_cache(struct cache_entry* cache) {
+  struct cache_entry* next;
+
+  while(cache != NULL) {
+    next = cache->next;
+    free_lp_result(cache->result);
+    free(cache);
+    cache = next;
+  }
+}
+
+// Answer of the same LP solved by the same mode, or NULL if it was never solved
+struct lp_result* find_result(struct cache_entry* cache, struct lp_key* key) {
+  for(; cache != NULL; cache = cache->next) {
+    if(same_problem(&cache->key, key)) {
+      return cache->result;
+    }
+  }
+
+  return NULL;
+}
+
+// A base read from the file must have (m - 1) different columns of the tableau, none of them in the operations
+// register or in b. m and n are the dimensions of the LP as it was read
+static int is_valid_base(int* base, int m, int n) {
+  int i, k, tableau_n;
+
+  tableau_n = n + (m - 1) + (m - 1);
+
+  for(i = 0; i < (m - 1); i++) {
+    if(base[i] < (m - 1) || base[i] > (tableau_n - 2)) {
+      return 0;
+    }
+    for(k = 0; k < i; k++) {
+      if(base[k] == base[i]) {
+        return 0;
+      }
+    }
+  }
+
+  return 1;
+}
+
+// Optimal base of an LP with the same A, or NULL if there is none. Any base of A is valid for a new b or c
+int* find_base(struct cache_entry* cache, struct lp_key* key) {
+  for(; cache != NULL; cache = cache->next) {
+    if(same_structure(&cache->key, key) && cache->result->base != NULL &&
+        is_valid_base(cache->result->base, key->m, key->n)) {
+      return cache->result->base;
+    }
+  }
+
+  return NULL;
+}
+
+// Writes the answer as one line. Values are written with enough digits to be read back exactly
+static void write_result(FILE* file, struct lp_key* key, struct lp_result* result) {
+  int i;
+
+  fprintf(file, "%d %d %llu %llu %llu %llu %c %.17g", key->m, key->n, key->problem.fnv, key->problem.sdbm,
+    key->structure.fnv, key->structure.sdbm, result->status, result->value);
+  for(i = 0; i < result->variables; i++) {
+    fprintf(file, " %.17g", (result->x != NULL) ? result->x[i] : 0);
+  }
+  for(i = 0; i < result->restrictions; i++) {
+    fprintf(file, " %.17g", (result->y != NULL) ? result->y[i] : 0);
+  }
+  for(i = 0; i < result->restrictions; i++) {
+    fprintf(file, " %d", (result->base != NULL) ? result->base[i] : -1);
+  }
+  fprintf(file, "\n");
+}
+
+// Saves the answer as the last entry of the cache file. The file is written again without the entries of the
+// same A, which the new one replaces, without cut lines and with at most MAX_CACHE_ENTRIES entries, so it
+// doesn't grow without bound. The new file is renamed over the old one, so a process killed while saving
+// leaves the old file whole
+void save_result(char* file_name, struct lp_key* key, struct lp_result* result) {
+  struct lp_key line_key;
+  char** lines;
+  char* line;
+  char* cursor;
+  char* temporary_name;
+  size_t size;
+  int i, count;
+  FILE* file;
+
+  lines = malloc(MAX_CACHE_ENTRIES * sizeof(char*));
+  count = 0;
+
+  // Keeps the last (MAX_CACHE_ENTRIES - 1) entries that stay, in a circular buffer
+  file = fopen(file_name, "r");
+  if(file != NULL) {
+    line = NULL;
+    size = 0;
+    while(getline(&line, &size, file) != -1) {
+      if(parse_key(line, &line_key, &cursor) && !same_structure(&line_key, key)) {
+        if(count >= (MAX_CACHE_ENTRIES - 1)) {
+          free(lines[count % (MAX_CACHE_ENTRIES - 1)]);
+        }
+        lines[count % (MAX_CACHE_ENTRIES - 1)] = strdup(line);
+        count++;
+      }
+    }
+    free(line);
+    fclose(file);
+  }
+
+  temporary_name = malloc(strlen(file_name) + 5);
+  sprintf(temporary_name, "%s.tmp", file_name);
+
+  file = fopen(temporary_name, "w");
+  if(file != NULL) {
+    for(i = (count > (MAX_CACHE_ENTRIES - 1)) ? (count - (MAX_CACHE_ENTRIES - 1)) : 0; i < count; i++) {
+      fputs(lines[i % (MAX_CACHE_ENTRIES - 1)], file);
+    }
+    write_result(file, key, result);
+    if(fclose(file) == 0) {
+      rename(temporary_name, file_name);
+    }
+    else {
+      remove(temporary_name);
+    }
+  }
+
+  for(i = 0; i < count && i < (MAX_CACHE_ENTRIES - 1); i++) {
+    free(lines[i]);
+  }
+  free(lines);
+  free(temporary_name);
+}
+
+void free_lp_result(struct lp_result* result) {
+  free(result->x);
+  free(result->y);
+  free(result->base);
+  free(result);
+}
@@ -0,0 +1,49 @@
+/* Result Cache
+ */
+
+#ifndef __CACHE_HEADER__
+#define __CACHE_HEADER__
+
+// Final answer of an LP, which is everything needed to print it again without solving the LP
+struct lp_result {
+  char status; // 'O' if optimal, 'I' if infeasible and 'U' if unbounded
+  int variables;
+  int restrictions;
+  double value;
+  double* x; // Optimal solution or certificate of unboundedness
+  double* y; // Dual optimal solution or certificate of infeasibility
+  int* base; // Optimal base in the tableau, only kept when status == 'O'
+};
+
+// Two independent 64 bit hashes of the same data, so two LPs only collide if both of them collide
+struct lp_hash {
+  unsigned long long fnv;
+  unsigned long long sdbm;
+};
+
+// Identifies an LP in the cache by its dimensions, as they were read, and its hashes. problem covers the
+// LP and the mode that solved it, structure only A, so LPs that differ only in b or c share it
+struct lp_key {
+  int m;
+  int n;
+  struct lp_hash problem;
+  struct lp_hash structure;
+};
+
+struct cache_entry {
+  struct lp_key key;
+  struct lp_result* result;
+  struct cache_entry* next;
+};
+
+void hash_lp(double** matrix, int m, int n, int mode, struct lp_key* key);
+
+struct cache_entry* load_cache(char* file_name, struct lp_key* key);
+void free_cache(struct cache_entry* cache);
+struct lp_result* find_result(struct cache_entry* cache, struct lp_key* key);
+int* find_base(struct cache_entry* cache, struct lp_key* key);
+void save_result(char* file_name, struct lp_key* key, struct lp_result* result);
+
+void free_lp_result(struct lp_result* result);
+
+#endif
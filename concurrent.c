@@ -0,0 +1,163 @@
+/* Concurrent Simplex Solver
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "lalgebra.h"
+#include "interior.h"
+#include "concurrent.h"
+
+// Number of solvers that race against each other
+#define NUM_SOLVERS 3
+
+// State of one race. Every race has its own, so races running at the same time don't cancel each other
+struct solver_race {
+  struct solver_run runs[NUM_SOLVERS];
+  atomic_int cancel; // Set by the winner to stop the other solvers at their next pivot
+  int winner; // Index of the first solver to finish. -1 while the race is still running
+  pthread_mutex_t lock; // Protects the choice of the winner
+};
+
+// Every solver calls this when it stops. The first one to get here wins and cancels the others
+static void finish_run(struct solver_race* solver_race, struct solver_run* run) {
+  pthread_mutex_lock(&solver_race->lock);
+  if(solver_race->winner == -1 && run->result != -2) {
+    solver_race->winner = run - solver_race->runs;
+    atomic_store(&solver_race->cancel, 1);
+  }
+  pthread_mutex_unlock(&solver_race->lock);
+}
+
+// Same path as mode 1: the auxiliar LP finds a feasible base and the primal simplex finishes from it
+void* run_primal(void* arg) {
+  struct solver_run* run = arg;
+  double** auxiliar_lp;
+  int auxiliar_n;
+
+  auxiliar_lp = create_auxiliar_lp(run->lp, run->m, run->n);
+  auxiliar_n = run->n + run->m - 1;
+
+  set_initial_base(auxiliar_lp, run->m, auxiliar_n, run->base);
+  run->result = primal_simplex(auxiliar_lp, run->m, auxiliar_n, run->base, 0, run->cancel);
+
+  if(run->result != -2) {
+    if(auxiliar_lp[0][auxiliar_n - 1] < 0) { // LP is infeasible
+      run->result = run->n - 1;
+      run->certificate = get_dual_optimal_solution(auxiliar_lp, run->m);
+    }
+    else {
+      remove_artificial_base(auxiliar_lp, run->m, auxiliar_n, run->base);
+      run->result = primal_simplex(run->lp, run->m, run->n, run->base, 0, run->cancel);
+    }
+  }
+
+  free_matrix(auxiliar_lp, run->m);
+
+  return NULL;
+}
+
+// The dual simplex starting from the slack variables, with its phase one when c is not positive
+void* run_dual(void* arg) {
+  struct solver_run* run = arg;
+
+  set_initial_base(run->lp, run->m, run->n, run->base);
+  run->result = dual_simplex(run->lp, run->m, run->n, run->base, 0, run->cancel);
+
+  if(run->result == (run->n - 1)) { // LP is infeasible
+    run->certificate = generate_infeasibility_certificate(run->lp, run->m, run->n);
+  }
+
+  return NULL;
+}
+
+// Interior point method followed by the crossover and the simplex from the base it finds
+void* run_interior_point(void* arg) {
+  struct solver_run* run = arg;
+
+  run->result = interior_point(run->lp, run->m, run->n, run->base, run->cancel);
+
+  if(run->result == (run->n - 1)) { // LP is infeasible
+    run->certificate = generate_infeasibility_certificate(run->lp, run->m, run->n);
+  }
+
+  return NULL;
+}
+
+// Solvers in the race. The index of each one is the index of its run
+static void* (*solvers[NUM_SOLVERS])(void*) = {run_primal, run_dual, run_interior_point};
+
+// Wraps the solver so it can report when it stops
+struct race_arg {
+  struct solver_race* solver_race;
+  int index;
+};
+
+static void* race(void* arg) {
+  struct race_arg* race_arg = arg;
+  struct solver_run* run = &race_arg->solver_race->runs[race_arg->index];
+
+  solvers[race_arg->index](run);
+  finish_run(race_arg->solver_race, run);
+
+  return NULL;
+}
+
+// Runs every solver on a copy of the LP in its own thread and returns the run of the first one to finish.
+// The others are cancelled at their next pivot. The original LP is not modified
+struct solver_run* concurrent_simplex(double** lp, int m, int n) {
+  struct solver_race solver_race;
+  struct solver_run* runs;
+  struct solver_run* result;
+  struct race_arg race_args[NUM_SOLVERS];
+  pthread_t threads[NUM_SOLVERS];
+  int i;
+
+  runs = solver_race.runs;
+  atomic_init(&solver_race.cancel, 0);
+  solver_race.winner = -1;
+  pthread_mutex_init(&solver_race.lock, NULL);
+
+  for(i = 0; i < NUM_SOLVERS; i++) {
+    runs[i].lp = allocate_matrix(m, n);
+    copy_matrix(lp, runs[i].lp, m, n);
+    runs[i].m = m;
+    runs[i].n = n;
+    runs[i].base = malloc((m - 1) * sizeof(int));
+    runs[i].result = -2;
+    runs[i].certificate = NULL;
+    runs[i].cancel = &solver_race.cancel;
+
+    race_args[i].solver_race = &solver_race;
+    race_args[i].index = i;
+    pthread_create(&threads[i], NULL, race, &race_args[i]);
+  }
+
+  for(i = 0; i < NUM_SOLVERS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  pthread_mutex_destroy(&solver_race.lock);
+
+  // Keeps only the winner's run. Its flag lives in this race, which is over
+  result = malloc(sizeof(struct solver_run));
+  *result = runs[solver_race.winner];
+  result->cancel = NULL;
+  for(i = 0; i < NUM_SOLVERS; i++) {
+    if(i != solver_race.winner) {
+      free_matrix(runs[i].lp, m);
+      free(runs[i].base);
+      free(runs[i].certificate);
+    }
+  }
+
+  return result;
+}
+
+void free_solver_run(struct solver_run* run) {
+  free_matrix(run->lp, run->m);
+  free(run->base);
+  free(run->certificate);
+  free(run);
+}
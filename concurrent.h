@@ -0,0 +1,28 @@
+/* Concurrent Simplex Solver
+ */
+
+#ifndef __CONCURRENT_HEADER__
+#define __CONCURRENT_HEADER__
+
+#include <stdatomic.h>
+
+// One solver of the race. Every solver works on its own copy of the LP, so the winner's tableau and base
+// can be used to extract the solution exactly like in the sequential modes
+struct solver_run {
+  double** lp; // Copy of the tableau the solver works on
+  int m; 
+  int n;
+  int* base;
+  int result; // -1 if optimal, (n - 1) if infeasible, column of the certificate if unbounded, -2 if cancelled
+  double* certificate; // Certificate of infeasibility, only set when result == (n - 1)
+  atomic_int* cancel; // Flag of the race, set when another solver wins
+};
+
+void* run_primal(void* arg);
+void* run_dual(void* arg);
+void* run_interior_point(void* arg);
+
+struct solver_run* concurrent_simplex(double** lp, int m, int n);
+void free_solver_run(struct solver_run* run);
+
+#endif
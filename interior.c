@@ -0,0 +1,636 @@
+/* Interior Point Solver
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "lalgebra.h"
+#include "interior.h"
+
+// Constant to solve floating point comparisons
+#define EPSILON 0.000001
+
+// Relative residuals and complementarity gap at which the interior point method stops
+#define TOLERANCE 0.00000001
+
+#define MAX_ITERATIONS 100
+
+// Fraction of the way to the boundary taken by each step, so z and w stay strictly positive
+#define STEP_FACTOR 0.9995
+
+// Threads used to build and factorize the normal equations. Below MIN_PARALLEL_ROWS rows the
+// cost of creating and synchronizing the threads is bigger than the work they would share
+#define NUM_THREADS 4
+#define MIN_PARALLEL_ROWS 64
+
+/***** NORMAL EQUATIONS ******/
+
+// Block of rows of the normal equations given to one thread
+struct factor_job {
+  struct interior_point* ip;
+  double** normal;
+  int from_row;
+  int to_row;
+};
+
+// Computes the rows [from_row, to_row) of the lower triangle of A D A^T
+static void* form_normal_rows(void* arg) {
+  struct factor_job* job = arg;
+  struct interior_point* ip = job->ip;
+  int i, j, p;
+
+  for(i = job->from_row; i < job->to_row; i++) {
+    for(j = 0; j <= i; j++) {
+      job->normal[i][j] = 0;
+      for(p = 0; p < ip->columns; p++) {
+        job->normal[i][j] += ip->a[i][p] * ip->d[p] * ip->a[j][p];
+      }
+    }
+  }
+
+  return NULL;
+}
+
+// Splits the rows [from_row, to_row) between the threads and waits for all of them to finish
+static void run_on_rows(void* (*work)(void*), struct factor_job* job, int from_row, int to_row) {
+  struct factor_job jobs[NUM_THREADS];
+  pthread_t threads[NUM_THREADS];
+  int t, chunk;
+
+  if((to_row - from_row) < MIN_PARALLEL_ROWS) {
+    job->from_row = from_row;
+    job->to_row = to_row;
+    work(job);
+    return;
+  }
+
+  chunk = (to_row - from_row + NUM_THREADS - 1) / NUM_THREADS;
+
+  for(t = 0; t < NUM_THREADS; t++) {
+    jobs[t] = *job;
+    jobs[t].from_row = from_row + t * chunk;
+    jobs[t].to_row = jobs[t].from_row + chunk;
+    if(jobs[t].to_row > to_row) {
+      jobs[t].to_row = to_row;
+    }
+    pthread_create(&threads[t], NULL, work, &jobs[t]);
+  }
+
+  for(t = 0; t < NUM_THREADS; t++) {
+    pthread_join(threads[t], NULL);
+  }
+}
+
+/***** CHOLESKY FACTORIZATION ******/
+
+// Barrier made with a mutex and a condition, since pthread barriers are not available everywhere
+struct barrier {
+  pthread_mutex_t lock;
+  pthread_cond_t all_arrived;
+  int count; // Threads that must arrive
+  int waiting;
+  int generation; // Counts how many times every thread arrived, so a thread can't pass twice in a row
+};
+
+static void wait_barrier(struct barrier* barrier) {
+  int generation;
+
+  if(barrier->count == 1) {
+    return;
+  }
+
+  pthread_mutex_lock(&barrier->lock);
+  generation = barrier->generation;
+  barrier->waiting++;
+  if(barrier->waiting == barrier->count) { // Last one releases the others
+    barrier->waiting = 0;
+    barrier->generation++;
+    pthread_cond_broadcast(&barrier->all_arrived);
+  }
+  else {
+    while(generation == barrier->generation) {
+      pthread_cond_wait(&barrier->all_arrived, &barrier->lock);
+    }
+  }
+  pthread_mutex_unlock(&barrier->lock);
+}
+
+// Factorization shared by the threads. Thread t owns the rows i with i % threads == t, so the rows below every
+// diagonal stay split evenly as the factorization moves to the right
+struct cholesky_job {
+  double** normal;
+  double** l;
+  int size;
+  int threads;
+  atomic_int failed_column; // Column whose diagonal shows that the matrix is not positive, or -1
+  struct barrier barrier;
+};
+
+struct cholesky_arg {
+  struct cholesky_job* job;
+  int thread;
+};
+
+// Computes the owned rows of every column of the factor. The diagonal of column k only needs row k, which
+// belongs to one thread, and the rows below it need the diagonal and row k. So each column takes one barrier
+// between its diagonal and the rows below it. Pivots that vanish as the method converges are replaced by a
+// huge number, which zeroes the matching component of the solution instead of stopping the factorization
+static void* factorize_columns(void* arg) {
+  struct cholesky_arg* cholesky_arg = arg;
+  struct cholesky_job* job = cholesky_arg->job;
+  double value;
+  int i, k, p;
+
+  for(k = 0; k < job->size; k++) {
+    if((k % job->threads) == cholesky_arg->thread) {
+      value = job->normal[k][k];
+      for(p = 0; p < k; p++) {
+        value -= job->l[k][p] * job->l[k][p];
+      }
+
+      if(isnan(value) || value < -EPSILON) {
+        atomic_store(&job->failed_column, k);
+      }
+      if(value < (TOLERANCE * TOLERANCE)) {
+        value = 1e128;
+      }
+      job->l[k][k] = sqrt(value);
+    }
+
+    // Every thread stops at the same column. Nothing is written to failed_column after that
+    wait_barrier(&job->barrier);
+    if(atomic_load(&job->failed_column) == k) {
+      return NULL;
+    }
+
+    // First owned row below the diagonal
+    i = (k + 1) + ((cholesky_arg->thread - (k + 1)) % job->threads + job->threads) % job->threads;
+    for(; i < job->size; i += job->threads) {
+      value = job->normal[i][k];
+      for(p = 0; p < k; p++) {
+        value -= job->l[i][p] * job->l[k][p];
+      }
+      job->l[i][k] = value / job->l[k][k];
+    }
+  }
+
+  return NULL;
+}
+
+// Left-looking Cholesky factorization of the lower triangle of normal into l. The threads are created once
+// and go through every column together. Returns 0 if the matrix is not positive
+int cholesky(double** normal, double** l, int size) {
+  struct cholesky_job job;
+  struct cholesky_arg args[NUM_THREADS];
+  pthread_t threads[NUM_THREADS];
+  int t;
+
+  job.normal = normal;
+  job.l = l;
+  job.size = size;
+  job.threads = (size >= MIN_PARALLEL_ROWS) ? NUM_THREADS : 1;
+  atomic_init(&job.failed_column, -1);
+  pthread_mutex_init(&job.barrier.lock, NULL);
+  pthread_cond_init(&job.barrier.all_arrived, NULL);
+  job.barrier.count = job.threads;
+  job.barrier.waiting = 0;
+  job.barrier.generation = 0;
+
+  for(t = 0; t < job.threads; t++) {
+    args[t].job = &job;
+    args[t].thread = t;
+  }
+  for(t = 1; t < job.threads; t++) { // This thread is the first one
+    pthread_create(&threads[t], NULL, factorize_columns, &args[t]);
+  }
+  factorize_columns(&args[0]);
+  for(t = 1; t < job.threads; t++) {
+    pthread_join(threads[t], NULL);
+  }
+
+  pthread_mutex_destroy(&job.barrier.lock);
+  pthread_cond_destroy(&job.barrier.all_arrived);
+
+  return atomic_load(&job.failed_column) == -1;
+}
+
+// Solves L L^T x = rhs by forward and backward substitution
+void cholesky_solve(double** l, int size, double* rhs, double* solution) {
+  int i, p;
+
+  for(i = 0; i < size; i++) {
+    solution[i] = rhs[i];
+    for(p = 0; p < i; p++) {
+      solution[i] -= l[i][p] * solution[p];
+    }
+    solution[i] /= l[i][i];
+  }
+
+  for(i = (size - 1); i >= 0; i--) {
+    for(p = (i + 1); p < size; p++) {
+      solution[i] -= l[p][i] * solution[p];
+    }
+    solution[i] /= l[i][i];
+  }
+}
+
+// Builds A D A^T with the current d and factorizes it
+static int factorize(struct interior_point* ip) {
+  struct factor_job job;
+
+  job.ip = ip;
+  job.normal = ip->normal;
+  run_on_rows(form_normal_rows, &job, 0, ip->rows);
+
+  return cholesky(ip->normal, ip->l, ip->rows);
+}
+
+/***** INTERIOR POINT METHOD ******/
+
+// Allocates the state and copies A, b and c from a tableau that has not been pivoted yet
+static struct interior_point* create_interior_point(double** matrix, int m, int n) {
+  struct interior_point* ip;
+  int i, j;
+
+  ip = malloc(sizeof(struct interior_point));
+  ip->rows = m - 1;
+  ip->columns = n - m; // Skips the operation register and b
+
+  ip->a = allocate_matrix(ip->rows, ip->columns);
+  ip->normal = allocate_matrix(ip->rows, ip->rows);
+  ip->l = allocate_matrix(ip->rows, ip->rows);
+  ip->b = malloc(ip->rows * sizeof(double));
+  ip->y = malloc(ip->rows * sizeof(double));
+  ip->dy = malloc(ip->rows * sizeof(double));
+  ip->rp = malloc(ip->rows * sizeof(double));
+  ip->c = malloc(ip->columns * sizeof(double));
+  ip->z = malloc(ip->columns * sizeof(double));
+  ip->w = malloc(ip->columns * sizeof(double));
+  ip->dz = malloc(ip->columns * sizeof(double));
+  ip->dw = malloc(ip->columns * sizeof(double));
+  ip->rd = malloc(ip->columns * sizeof(double));
+  ip->rc = malloc(ip->columns * sizeof(double));
+  ip->d = malloc(ip->columns * sizeof(double));
+
+  for(i = 0; i < ip->rows; i++) {
+    for(j = 0; j < ip->columns; j++) {
+      ip->a[i][j] = matrix[i + 1][j + (m - 1)];
+    }
+    ip->b[i] = matrix[i + 1][n - 1];
+  }
+
+  // The first row of the tableau already holds -c, which is the cost of the minimization
+  for(j = 0; j < ip->columns; j++) {
+    ip->c[j] = matrix[0][j + (m - 1)];
+  }
+
+  return ip;
+}
+
+static void free_interior_point(struct interior_point* ip) {
+  free_matrix(ip->a, ip->rows);
+  free_matrix(ip->normal, ip->rows);
+  free_matrix(ip->l, ip->rows);
+  free(ip->b);
+  free(ip->y);
+  free(ip->dy);
+  free(ip->rp);
+  free(ip->c);
+  free(ip->z);
+  free(ip->w);
+  free(ip->dz);
+  free(ip->dw);
+  free(ip->rd);
+  free(ip->rc);
+  free(ip->d);
+  free(ip);
+}
+
+// Updates the residuals and returns the average complementarity z^T w / columns
+static double compute_residuals(struct interior_point* ip) {
+  double mu;
+  int i, j;
+
+  for(i = 0; i < ip->rows; i++) {
+    ip->rp[i] = ip->b[i];
+    for(j = 0; j < ip->columns; j++) {
+      ip->rp[i] -= ip->a[i][j] * ip->z[j];
+    }
+  }
+
+  mu = 0;
+  for(j = 0; j < ip->columns; j++) {
+    ip->rd[j] = ip->c[j] - ip->w[j];
+    for(i = 0; i < ip->rows; i++) {
+      ip->rd[j] -= ip->a[i][j] * ip->y[i];
+    }
+    mu += ip->z[j] * ip->w[j];
+  }
+
+  return mu / ip->columns;
+}
+
+// Solves the Newton system for the complementarity target in rc using the factorization of A D A^T.
+// Eliminating dz and dw leaves (A D A^T) dy = rp - A W^-1 rc + A D rd
+static void newton_direction(struct interior_point* ip) {
+  double* rhs;
+  int i, j;
+
+  rhs = malloc(ip->rows * sizeof(double));
+
+  for(i = 0; i < ip->rows; i++) {
+    rhs[i] = ip->rp[i];
+    for(j = 0; j < ip->columns; j++) {
+      rhs[i] += ip->a[i][j] * (ip->d[j] * ip->rd[j] - ip->rc[j] / ip->w[j]);
+    }
+  }
+
+  cholesky_solve(ip->l, ip->rows, rhs, ip->dy);
+
+  for(j = 0; j < ip->columns; j++) {
+    ip->dw[j] = ip->rd[j];
+    for(i = 0; i < ip->rows; i++) {
+      ip->dw[j] -= ip->a[i][j] * ip->dy[i];
+    }
+    ip->dz[j] = (ip->rc[j] - ip->z[j] * ip->dw[j]) / ip->w[j];
+  }
+
+  free(rhs);
+}
+
+// Largest step in [0, 1] along direction that keeps vector non negative
+static double max_step(double* vector, double* direction, int size) {
+  double step;
+  int j;
+
+  step = 1;
+  for(j = 0; j < size; j++) {
+    if(direction[j] < 0 && (-1 * vector[j] / direction[j]) < step) {
+      step = -1 * vector[j] / direction[j];
+    }
+  }
+
+  return step;
+}
+
+// Mehrotra's starting point: the least squares solutions of Az = b and A^T y + w = c, shifted
+// so that z and w are positive and not too far from each other
+static int starting_point(struct interior_point* ip) {
+  double* rhs;
+  double shift_z, shift_w, product, sum_z, sum_w;
+  int i, j;
+
+  rhs = malloc(ip->rows * sizeof(double));
+
+  for(j = 0; j < ip->columns; j++) {
+    ip->d[j] = 1;
+  }
+  if(!factorize(ip)) {
+    free(rhs);
+    return 0;
+  }
+
+  // z = A^T (A A^T)^-1 b
+  cholesky_solve(ip->l, ip->rows, ip->b, rhs);
+  for(j = 0; j < ip->columns; j++) {
+    ip->z[j] = 0;
+    for(i = 0; i < ip->rows; i++) {
+      ip->z[j] += ip->a[i][j] * rhs[i];
+    }
+  }
+
+  // y = (A A^T)^-1 A c and w = c - A^T y
+  for(i = 0; i < ip->rows; i++) {
+    ip->rp[i] = 0;
+    for(j = 0; j < ip->columns; j++) {
+      ip->rp[i] += ip->a[i][j] * ip->c[j];
+    }
+  }
+  cholesky_solve(ip->l, ip->rows, ip->rp, ip->y);
+  for(j = 0; j < ip->columns; j++) {
+    ip->w[j] = ip->c[j];
+    for(i = 0; i < ip->rows; i++) {
+      ip->w[j] -= ip->a[i][j] * ip->y[i];
+    }
+  }
+
+  shift_z = 0;
+  shift_w = 0;
+  for(j = 0; j < ip->columns; j++) {
+    if(-1.5 * ip->z[j] > shift_z) {
+      shift_z = -1.5 * ip->z[j];
+    }
+    if(-1.5 * ip->w[j] > shift_w) {
+      shift_w = -1.5 * ip->w[j];
+    }
+  }
+
+  product = 0;
+  sum_z = 0;
+  sum_w = 0;
+  for(j = 0; j < ip->columns; j++) {
+    ip->z[j] += shift_z;
+    ip->w[j] += shift_w;
+    product += ip->z[j] * ip->w[j];
+    sum_z += ip->z[j];
+    sum_w += ip->w[j];
+  }
+
+  for(j = 0; j < ip->columns; j++) {
+    // Avoids a zero start when b and c are both zero
+    ip->z[j] += (sum_w > 0) ? (0.5 * product / sum_w) : 1;
+    ip->w[j] += (sum_z > 0) ? (0.5 * product / sum_z) : 1;
+  }
+
+  free(rhs);
+
+  return 1;
+}
+
+// Runs Mehrotra's predictor-corrector method. Returns 1 if it converged, 0 if it stopped before that
+// (which happens for infeasible and unbounded LPs) and -2 if cancel was set
+static int mehrotra(struct interior_point* ip, atomic_int* cancel) {
+  double mu, mu_affine, sigma, step_primal, step_dual, norm_b, norm_c, norm_rp, norm_rd;
+  int i, j, iteration;
+
+  if(!starting_point(ip)) {
+    return 0;
+  }
+
+  norm_b = 0;
+  for(i = 0; i < ip->rows; i++) {
+    norm_b = fmax(norm_b, fabs(ip->b[i]));
+  }
+  norm_c = 0;
+  for(j = 0; j < ip->columns; j++) {
+    norm_c = fmax(norm_c, fabs(ip->c[j]));
+  }
+
+  for(iteration = 0; iteration < MAX_ITERATIONS; iteration++) {
+    if(is_cancelled(cancel)) { // Other solver already finished
+      return -2;
+    }
+
+    mu = compute_residuals(ip);
+
+    norm_rp = 0;
+    for(i = 0; i < ip->rows; i++) {
+      norm_rp = fmax(norm_rp, fabs(ip->rp[i]));
+    }
+    norm_rd = 0;
+    for(j = 0; j < ip->columns; j++) {
+      norm_rd = fmax(norm_rd, fabs(ip->rd[j]));
+    }
+
+    if(isnan(mu) || isnan(norm_rp) || isnan(norm_rd)) {
+      return 0;
+    }
+    if(norm_rp / (1 + norm_b) < TOLERANCE && norm_rd / (1 + norm_c) < TOLERANCE && mu < TOLERANCE) {
+      return 1;
+    }
+
+    for(j = 0; j < ip->columns; j++) {
+      ip->d[j] = ip->z[j] / ip->w[j];
+    }
+    if(!factorize(ip)) {
+      return 0;
+    }
+
+    // Predictor: pure Newton step towards z_j w_j = 0
+    for(j = 0; j < ip->columns; j++) {
+      ip->rc[j] = -1 * ip->z[j] * ip->w[j];
+    }
+    newton_direction(ip);
+
+    step_primal = max_step(ip->z, ip->dz, ip->columns);
+    step_dual = max_step(ip->w, ip->dw, ip->columns);
+
+    mu_affine = 0;
+    for(j = 0; j < ip->columns; j++) {
+      mu_affine += (ip->z[j] + step_primal * ip->dz[j]) * (ip->w[j] + step_dual * ip->dw[j]);
+    }
+    mu_affine /= ip->columns;
+
+    sigma = pow(mu_affine / mu, 3);
+
+    // Corrector: aims at sigma * mu and compensates the second order term of the predictor
+    for(j = 0; j < ip->columns; j++) {
+      ip->rc[j] = sigma * mu - ip->z[j] * ip->w[j] - ip->dz[j] * ip->dw[j];
+    }
+    newton_direction(ip);
+
+    step_primal = fmin(1, STEP_FACTOR * max_step(ip->z, ip->dz, ip->columns));
+    step_dual = fmin(1, STEP_FACTOR * max_step(ip->w, ip->dw, ip->columns));
+
+    for(j = 0; j < ip->columns; j++) {
+      ip->z[j] += step_primal * ip->dz[j];
+      ip->w[j] += step_dual * ip->dw[j];
+    }
+    for(i = 0; i < ip->rows; i++) {
+      ip->y[i] += step_dual * ip->dy[i];
+    }
+  }
+
+  return 0;
+}
+
+/***** CROSSOVER ******/
+
+// Column of the tableau and how likely it is to be basic at the optimum
+struct column_rank {
+  int column;
+  double value;
+};
+
+static int compare_rank(const void* first, const void* second) {
+  double difference = ((struct column_rank*) second)->value - ((struct column_rank*) first)->value;
+
+  return (difference > 0) - (difference < 0);
+}
+
+// Builds a base from the interior point, trying the columns in decreasing order of z_j / w_j. Each column
+// is pivoted in the free row where it has the largest element, so the chosen columns are always linearly
+// independent and the tableau ends up in the canonical form for the base. Returns 0 if some row was left
+// without a base, which can only happen through floating point errors
+int crossover(double** matrix, int m, int n, int* base, double* z, double* w) {
+  struct column_rank* ranks;
+  int* row_used;
+  int i, j, k, row, found;
+
+  ranks = malloc((n - m) * sizeof(struct column_rank));
+  row_used = calloc(m, sizeof(int));
+
+  for(j = 0; j < (n - m); j++) {
+    ranks[j].column = j + (m - 1);
+    ranks[j].value = z[j] / w[j];
+    if(isnan(ranks[j].value)) {
+      ranks[j].value = 0;
+    }
+  }
+  qsort(ranks, (n - m), sizeof(struct column_rank), compare_rank);
+
+  found = 0;
+  for(k = 0; k < (n - m) && found < (m - 1); k++) {
+    j = ranks[k].column;
+
+    row = 0;
+    for(i = 1; i < m; i++) {
+      if(!row_used[i] && fabs(matrix[i][j]) > EPSILON && (row == 0 || fabs(matrix[i][j]) > fabs(matrix[row][j]))) {
+        row = i;
+      }
+    }
+    if(row == 0) { // Column depends on the ones already in the base
+      continue;
+    }
+
+    operate_on_rows(matrix, row, n, (1 / matrix[row][j]), -1);
+    for(i = 0; i < m; i++) {
+      if(i != row && matrix[i][j] != 0) {
+        operate_on_rows(matrix, row, n, (-1 * matrix[i][j]), i);
+      }
+    }
+
+    base[row - 1] = j;
+    row_used[row] = 1;
+    found++;
+  }
+
+  free(ranks);
+  free(row_used);
+
+  return (found == (m - 1));
+}
+
+// Solves the LP with the interior point method and recovers a base with the crossover. The simplex then
+// finishes from that base, so the tableau, base and certificates are the same as in the simplex modes.
+// Infeasible and unbounded LPs never converge and are detected by this last simplex. Must receive a
+// tableau that has not been pivoted yet. Returns the same values as the dual simplex
+int interior_point(double** matrix, int m, int n, int* base, atomic_int* cancel) {
+  struct interior_point* ip;
+  double** original;
+  int result;
+
+  ip = create_interior_point(matrix, m, n);
+  result = mehrotra(ip, cancel);
+
+  if(result == -2) {
+    free_interior_point(ip);
+    return -2;
+  }
+
+  original = allocate_matrix(m, n);
+  copy_matrix(matrix, original, m, n);
+
+  if(!crossover(matrix, m, n, base, ip->z, ip->w)) { // Starts again from the slack variables
+    copy_matrix(original, matrix, m, n);
+    set_initial_base(matrix, m, n, base);
+  }
+
+  free_matrix(original, m);
+  free_interior_point(ip);
+
+  return dual_simplex(matrix, m, n, base, 0, cancel);
+}
@@ -0,0 +1,37 @@
+/* Interior Point Solver
+ */
+
+#ifndef __INTERIOR_HEADER__
+#define __INTERIOR_HEADER__
+
+#include <stdatomic.h>
+
+// State of the primal-dual interior point method for min c^T z, Az = b, z >= 0. A is the [A I] part of the
+// tableau, so it has (m - 1) rows and one column for every variable and slack. w are the dual slacks
+struct interior_point {
+  int rows;
+  int columns;
+  double** a;
+  double* b;
+  double* c;
+  double* z;
+  double* y;
+  double* w;
+  double* dz; // Newton direction
+  double* dy;
+  double* dw;
+  double* rp; // Primal residual b - Az
+  double* rd; // Dual residual c - A^T y - w
+  double* rc; // Complementarity target for the current direction
+  double* d;  // Diagonal scaling z / w of the normal equations
+  double** normal; // A D A^T
+  double** l; // Cholesky factor of the normal equations
+};
+
+int cholesky(double** normal, double** l, int size);
+void cholesky_solve(double** l, int size, double* rhs, double* solution);
+
+int crossover(double** matrix, int m, int n, int* base, double* z, double* w);
+int interior_point(double** matrix, int m, int n, int* base, atomic_int* cancel);
+
+#endif
@@ -7,12 +7,17 @@
 #include <string.h>
 #include <math.h>
 #include <ctype.h>
+#include <stdatomic.h>
 
 #include "lalgebra.h"
 
 // Constant to solve floating point comparisons
 #define EPSILON 0.000001
 
+// Step between the costs given to the columns shifted by the dual phase one. It must stay above EPSILON, or
+// the row operations would round the shifted costs back to 0
+#define COST_PERTURBATION 0.00001
+
 /***** INPUT AND OUTPUT ******/
 
 // Parses through the input file and format the given linear programming
@@ -20,6 +25,7 @@ void parse_input(FILE* input, double** matrix, int m, int n) {
   int i, j, input_size;
 
   i = 0;
+  j = 0;
 
   input_size = (2 + (4 * m) + (m * (9 * n))); // Approximated size of input
   char* input_matrix = malloc(input_size * sizeof(char)); // Unformated LP
@@ -92,6 +98,16 @@ double** allocate_matrix(int m, int n) {
   return matrix;
 }
 
+// Free every row of the matrix and then the matrix itself
+void free_matrix(double** matrix, int m) {
+  int i;
+
+  for(i = 0; i < m; i++) {
+    free(matrix[i]);
+  }
+  free(matrix);
+}
+
 // Creates identity matrix of dimensions m x m.
 double** identity(int m) {
   double** identity_matrix;
@@ -174,9 +190,7 @@ void operate_on_rows(double** matrix, int row, int n, double multiply_by, int su
   }
 
   for(j = 0; j < n; j++) { // Create new row multiplied by multiply_by
-    if(matrix[row][j] != 0) {
-      new_row[j] = matrix[row][j] * multiply_by;
-    }
+    new_row[j] = matrix[row][j] * multiply_by;
   }
 
   if(sum_to == -1) { // Operations should stay in the same row
@@ -195,6 +209,8 @@ void operate_on_rows(double** matrix, int row, int n, double multiply_by, int su
       }
     } 
   }
+
+  free(new_row);
 }
 
 // Offers a way to make linear operations. If sum_to is -1, replaces the actual line. m stands for the 
@@ -211,9 +227,7 @@ void operate_on_columns(double** matrix, int m, int column, double multiply_by,
   }
 
   for(i = 0; i < m; i++) { // Create new column multiplied by multiply_by
-    if(matrix[i][column] != 0) {
-      new_column[i] = matrix[i][column] * multiply_by;
-    }
+    new_column[i] = matrix[i][column] * multiply_by;
   }
 
   if(sum_to == -1) { // Operations should stay in the same column
@@ -232,6 +246,8 @@ void operate_on_columns(double** matrix, int m, int column, double multiply_by,
       }
     } 
   }
+
+  free(new_column);
 }
 
 // Format the LP to the Standard Equality Form adding the slack variables
@@ -244,8 +260,8 @@ double** format_sef(double** original_matrix, int m, int n) {
 
   new_matrix = allocate_matrix(m, (n + new_columns));
 
-  // Set first row to 0
-  for(j = 0; j < new_columns; j++) {
+  // Set the first row to 0 above the slack variables
+  for(j = (n - 1); j < (new_n - 1); j++) {
     new_matrix[0][j] = 0; 
   }
 
@@ -253,7 +269,7 @@ double** format_sef(double** original_matrix, int m, int n) {
   insert_matrix(original_matrix, new_matrix, 1, m, 1, (n - 1));
 
   // Adds the identity matrix in the correct position
-  insert_matrix(identity(new_columns), new_matrix, 2, m, n, (n + new_columns)); 
+  insert_matrix(identity(new_columns), new_matrix, 2, m, n, (n + new_columns - 1)); 
 
   // Adds the last column of the original LP to the new one
   for(i = 0; i < m; i++) {
@@ -340,6 +356,57 @@ double** create_auxiliar_lp(double** matrix, int m, int n) {
   return auxiliar_lp;
 }
 
+// Creates a copy of the tableau with the new restriction sign * x <= bound, where x is the variable of the given
+// column. The restriction gets its own slack, added right before b, and its own column at the end of the
+// operations register. Every column after the register moves one position to the right
+double** add_bound_row(double** matrix, int m, int n, int column, double sign, double bound) {
+  double** new_matrix;
+  int i, j;
+
+  new_matrix = allocate_matrix((m + 1), (n + 2));
+
+  for(i = 0; i < m; i++) {
+    for(j = 0; j < (m - 1); j++) { // Operations register
+      new_matrix[i][j] = matrix[i][j];
+    }
+    new_matrix[i][m - 1] = 0;
+    for(j = (m - 1); j < (n - 1); j++) { // Variables and slacks
+      new_matrix[i][j + 1] = matrix[i][j];
+    }
+    new_matrix[i][n] = 0;
+    new_matrix[i][n + 1] = matrix[i][n - 1];
+  }
+
+  for(j = 0; j < (n + 2); j++) {
+    new_matrix[m][j] = 0;
+  }
+  new_matrix[m][m - 1] = 1;
+  new_matrix[m][column + 1] = sign;
+  new_matrix[m][n] = 1;
+  new_matrix[m][n + 1] = bound;
+
+  return new_matrix;
+}
+
+// When the auxiliar LP is degenerate, artificial variables can stay in the base with value 0. Each one is replaced
+// by a column of the original LP that is not zero in its row, so the base can be used by the original LP
+void remove_artificial_base(double** auxiliar_lp, int m, int auxiliar_n, int* base) {
+  int i, j;
+
+  for(i = 0; i < (m - 1); i++) {
+    // Artificial columns are the last (m - 1) before b. If the value is not 0 the original LP is infeasible
+    if(base[i] >= (auxiliar_n - m) && fabs(auxiliar_lp[i + 1][auxiliar_n - 1]) < EPSILON) {
+      for(j = (m - 1); j < (auxiliar_n - m); j++) {
+        if(fabs(auxiliar_lp[i + 1][j]) > EPSILON) {
+          base[i] = j;
+          format_canonical(auxiliar_lp, m, auxiliar_n, base);
+          break;
+        }
+      }
+    }
+  }
+}
+
 // Check if b has any negative element
 int is_b_negative(double** matrix, int m, int n) {
   int i;
@@ -377,6 +444,10 @@ int is_c_positive(double** matrix, int m, int n) {
   return 1;
 }
 
+// The simplex loops stop at their next pivot when the flag they received is set. A NULL flag is never set
+int is_cancelled(atomic_int* cancel) {
+  return cancel != NULL && atomic_load(cancel);
+}
 
 // Set the base to the default: Last (m - 1) columns of the A matrix
 void set_initial_base(double** matrix, int m, int n, int* base) {
@@ -388,11 +459,11 @@ void set_initial_base(double** matrix, int m, int n, int* base) {
   }
 }
 
-// Finds first non zero element on received column and returns it's index
-int find_non_zero_element(double** matrix, int m, int column) {
+// Finds first non zero element on received column, starting at from_row, and returns it's index
+int find_non_zero_element(double** matrix, int m, int column, int from_row) {
   int i;
 
-  for(i = 1; i < m; i++) {
+  for(i = from_row; i < m; i++) {
     if(matrix[i][column] != 0) {
       return i;
     }
@@ -406,9 +477,10 @@ void format_canonical(double** matrix, int m, int n, int* base) {
   int i, j;
 
   for(i = 0; i < (m - 1); i++) { // Goes through all the basic columns
-    // If the row for the base is 0, find other row on the same column that can make the first one != 0
+    // If the row for the base is 0, find other row on the same column that can make the first one != 0.
+    // Only the rows below it are used, since adding a row that already has its base would undo that base
     if(matrix[i + 1][base[i]] == 0) { 
-      operate_on_rows(matrix, (find_non_zero_element(matrix, m, base[i])), n, 1, (i + 1));
+      operate_on_rows(matrix, (find_non_zero_element(matrix, m, base[i], (i + 2))), n, 1, (i + 1));
     }
     if(matrix[i + 1][base[i]] != 1) { // Make element equals 1
       operate_on_rows(matrix, (i + 1), n, (1 / matrix[i + 1][base[i]]), -1);
@@ -424,42 +496,57 @@ void format_canonical(double** matrix, int m, int n, int* base) {
 }
 
 // Returns if LP is unbounded(column number), optimal(-1) or if we need one more round of simplex(0).
-// Uses Bland's Rule to prevent loops. Pass the row and column of the base by reference
-int primal_next_base(double** matrix, int m, int n, int* base_row, int* base_column) {
+// Uses Bland's Rule to prevent loops: the first column with negative cost enters and ties in the ratio test go
+// to the row whose basic column has the smallest index. Pass the row and column of the base by reference
+int primal_next_base(double** matrix, int m, int n, int* base, int* base_row, int* base_column) {
   int i, j;
   double min_ratio, row_ratio;
 
-  min_ratio = 999999;
-
   for(j = (m - 1); j < (n - 1); j++) { // Skips the operation register columns
     if(matrix[0][j] < 0) { // Chooses the first negative element in the first row
-      *base_column = j;
-      for(i = 1; i < m; i++) {
-        // b will never be negative after primal simplex starts to run, so,
-        // for a valid ratio, we need a positive number that is not zero
-        if(matrix[i][j] > 0) {
-          row_ratio = matrix[i][n - 1] / matrix[i][j];
-          if(row_ratio <= min_ratio + EPSILON) {  
-            min_ratio = row_ratio;
-            *base_row = i; // Chooses row with minimum ratio in that column
-          }
-        }
-      }
-      if(min_ratio == 999999) {
-        return j; // LP is unbounded
+      break;
+    }
+  }
+
+  if(j == (n - 1)) {
+    return -1; // LP is optimal
+  }
+
+  *base_column = j;
+  min_ratio = 999999;
+
+  for(i = 1; i < m; i++) {
+    // b will never be negative after primal simplex starts to run, so,
+    // for a valid ratio, we need a positive number that is not zero
+    if(matrix[i][j] > 0) {
+      row_ratio = matrix[i][n - 1] / matrix[i][j];
+      if(row_ratio < min_ratio) {
+        min_ratio = row_ratio;
       }
-      else {
-        return 0; // Goes to the next round of simplex
+    }
+  }
+
+  if(min_ratio == 999999) {
+    return j; // LP is unbounded
+  }
+
+  *base_row = 0;
+
+  for(i = 1; i < m; i++) { // Chooses among the rows that reach the minimum ratio
+    if(matrix[i][j] > 0 && (matrix[i][n - 1] / matrix[i][j]) <= min_ratio + EPSILON) {
+      if(*base_row == 0 || base[i - 1] < base[*base_row - 1]) {
+        *base_row = i;
       }
     }
   }
 
-  return -1; // LP is optimal
+  return 0; // Goes to the next round of simplex
 }
 
 // If return == -1 the LP is optimal and if return > 0 it's unbounded. In the last case,
-// the return value equals the column where we can get the certificate of unboundedness
-int primal_simplex(double** matrix, int m, int n, int* base, int print_output) {  
+// the return value equals the column where we can get the certificate of unboundedness.
+// Returns -2 if cancel was set
+int primal_simplex(double** matrix, int m, int n, int* base, int print_output, atomic_int* cancel) {  
   int result, new_base_row, new_base_column;
 
   make_b_non_negative(matrix, m, n);
@@ -478,53 +565,115 @@ int primal_simplex(double** matrix, int m, int n, int* base, int print_output) {
     }
 
     // Find the next base for the primal simplex
-    result = primal_next_base(matrix, m, n, &new_base_row, &new_base_column);
+    result = primal_next_base(matrix, m, n, base, &new_base_row, &new_base_column);
 
     if(result != 0) { // If LP is optimal or unbounded
       return result;
     }
 
     base[new_base_row - 1] = new_base_column; // Adds chosen column to the base
+
+    if(is_cancelled(cancel)) { // Other solver already finished
+      return -2;
+    }
   }
 }
 
 
-// Returns if LP is unbounded(column number), optimal(-1) or if we need one more round of simplex(0).
-// Uses Bland's Rule to prevent loops. Pass the row and column of the base by reference
-int dual_next_base(double** matrix, int m, int n, int* base_row, int* base_column) {
+// Returns if LP is infeasible(n - 1), optimal(-1) or if we need one more round of simplex(0). Uses the dual
+// version of Bland's Rule to prevent loops: the leaving row is the one with negative b whose basic column has
+// the smallest index, and ties in the ratio test go to the smallest column. Pass the row and column of the
+// base by reference
+int dual_next_base(double** matrix, int m, int n, int* base, int* base_row, int* base_column) {
   int i, j;
   double min_ratio, row_ratio;
 
-  min_ratio = 999999;
+  *base_row = 0;
 
-  for(i = 1; i < m; i++) {
-    if(matrix[i][n - 1] < 0) {
+  for(i = 1; i < m; i++) { // Chooses the row with negative b whose basic column comes first
+    if(matrix[i][n - 1] < 0 && (*base_row == 0 || base[i - 1] < base[*base_row - 1])) {
       *base_row = i;
-      for(j = (m - 1); j < (n - 1); j++) {
-        if(matrix[i][j] < 0) {
-          row_ratio = matrix[0][j] / (-1 * matrix[i][j]);
-          if(row_ratio >= 0 && row_ratio < min_ratio) {
-            min_ratio = row_ratio;
-            *base_column = j;
-          }
-        }
-      }
-      if(min_ratio == 999999) {
-        return j; // LP is unbounded
+    }
+  }
+
+  if(*base_row == 0) {
+    return -1; // LP is optimal
+  }
+
+  i = *base_row;
+  min_ratio = 999999;
+
+  // A cost slightly below 0 only comes from rounding after a near tie, so it counts as 0 in the ratio
+  for(j = (m - 1); j < (n - 1); j++) { // Skips the operation register columns
+    if(matrix[i][j] < 0) {
+      row_ratio = fmax(matrix[0][j], 0) / (-1 * matrix[i][j]);
+      if(row_ratio < min_ratio) {
+        min_ratio = row_ratio;
       }
-      else {
-        return 0; // Goes to the next round of simplex
+    }
+  }
+
+  if(min_ratio == 999999) {
+    return (n - 1); // LP is infeasible
+  }
+
+  for(j = (m - 1); j < (n - 1); j++) { // First column that reaches the minimum ratio
+    if(matrix[i][j] < 0) {
+      row_ratio = fmax(matrix[0][j], 0) / (-1 * matrix[i][j]);
+      if(row_ratio <= min_ratio + EPSILON) {
+        *base_column = j;
+        break;
       }
     }
   }
 
-  return -1; // LP is optimal
+  return 0; // Goes to the next round of simplex
 }
 
-// If return == -1 the LP is optimal and if return > 0 it's unbounded. In the last case,
-// the return value equals the column where we can get the certificate of unboundedness
-int dual_simplex(double** matrix, int m, int n, int* base, int print_output) {
-  int result, new_base_row, new_base_column;
+// Dual phase one by cost shifting. Every negative element in the first row is raised to a small positive cost,
+// which makes the tableau dual feasible. The costs are different for each column, so the shifted columns don't
+// tie in the ratio test. The amount added to each column is saved in shift. Returns 1 if any cost was shifted
+int shift_costs(double** matrix, int m, int n, double* shift) {
+  int j, shifted;
+
+  shifted = 0;
+
+  for(j = 0; j < (n - 1); j++) {
+    shift[j] = 0;
+    if(j >= (m - 1) && matrix[0][j] < 0) { // Skips the operation register columns
+      shift[j] = (COST_PERTURBATION * (j - (m - 1) + 1)) - matrix[0][j];
+      matrix[0][j] += shift[j];
+      shifted = 1;
+    }
+  }
+
+  return shifted;
+}
+
+// Removes the shift added by shift_costs. The first row is then formatted again for the current base, since
+// the multiples of the other rows added to it during the dual simplex were computed with the shifted costs
+void unshift_costs(double** matrix, int m, int n, int* base, double* shift) {
+  int j;
+
+  for(j = (m - 1); j < (n - 1); j++) {
+    matrix[0][j] -= shift[j];
+  }
+
+  format_canonical(matrix, m, n, base);
+}
+
+// If return == -1 the LP is optimal and if return == (n - 1) it's infeasible. Otherwise it's unbounded and
+// the return value equals the column where we can get the certificate of unboundedness. If c is not positive
+// the costs are shifted until b is non negative and then the original costs are restored for the primal simplex.
+// Returns -2 if cancel was set
+int dual_simplex(double** matrix, int m, int n, int* base, int print_output, atomic_int* cancel) {
+  int result, shifted, new_base_row, new_base_column;
+  double* shift;
+
+  shift = malloc((n - 1) * sizeof(double));
+
+  format_canonical(matrix, m, n, base);
+  shifted = shift_costs(matrix, m, n, shift);
 
   while(1) {
 
@@ -539,15 +688,36 @@ int dual_simplex(double** matrix, int m, int n, int* base, int print_output) {
       print_output_matrix(matrix, m, n);
     }
 
-    // Find the next base for the primal simplex
-    result = dual_next_base(matrix, m, n, &new_base_row, &new_base_column);
+    // Find the next base for the dual simplex
+    result = dual_next_base(matrix, m, n, base, &new_base_row, &new_base_column);
 
-    if(result != 0) { // If LP is optimal or unbounded
-      return result;
+    if(result != 0) { // If LP is optimal or infeasible
+      break;
     }
 
     base[new_base_row - 1] = new_base_column; // Adds chosen column to the base
+
+    if(is_cancelled(cancel)) { // Other solver already finished
+      result = -2;
+      break;
+    }
   }
+
+  // The base is feasible but was only optimal for the shifted costs, so the primal simplex finishes the job
+  if(shifted && result == -1) {
+    unshift_costs(matrix, m, n, base, shift);
+    result = primal_simplex(matrix, m, n, base, print_output, cancel);
+  }
+  else if(shifted && result == (n - 1)) { // The final tableau shows the original costs
+    unshift_costs(matrix, m, n, base, shift);
+    if(print_output) {
+      print_output_matrix(matrix, m, n);
+    }
+  }
+
+  free(shift);
+
+  return result;
 }
 
 // Extract solution from optimal LP based in the base of columns
@@ -605,4 +775,28 @@ double* generate_unboundedness_certificate(double** matrix, int m, int n, int co
   }
 
   return vector;
-}
\ No newline at end of file
+}
+
+// The dual simplex finds the LP infeasible at a row with negative b and no negative element. Its operations
+// register is a non negative y with y^T A >= 0 and y^T b < 0, which certifies the infeasibility
+double* generate_infeasibility_certificate(double** matrix, int m, int n) {
+  double* vector;
+  int i, j, k;
+
+  vector = malloc((m - 1) * sizeof(double));
+
+  for(i = 1; i < m; i++) {
+    if(matrix[i][n - 1] < 0) {
+      for(j = (m - 1); j < (n - 1) && matrix[i][j] >= 0; j++);
+      if(j == (n - 1)) {
+        break;
+      }
+    }
+  }
+
+  for(k = 0; k < (m - 1); k++) {
+    vector[k] = matrix[i][k];
+  }
+
+  return vector;
+}
@@ -5,6 +5,8 @@
 #ifndef __LALGEBRA_HEADER__
 #define __LALGEBRA_HEADER__
 
+#include <stdatomic.h>
+
 /***** INPUT AND OUTPUT ******/
 void parse_input(FILE* input, double** matrix, int m, int n);
 void print_output_vector(double* vector, int n);
@@ -12,6 +14,7 @@ void print_output_matrix(double** matrix, int m, int n);
 
 /***** MATRIX OPERATIONS ******/
 double** allocate_matrix(int m, int n);
+void free_matrix(double** matrix, int m);
 double** identity(int m);
 void print_matrix(double** matrix, int m, int n);
 void copy_matrix(double** original, double** copy, int m, int n);
@@ -24,22 +27,29 @@ double** format_sef(double** matrix, int m, int n);
 void format_tableau(double** matrix, int m, int n);
 double** add_operations_register(double** matrix, int m, int n);
 double** create_auxiliar_lp(double** matrix, int m, int n);
+void remove_artificial_base(double** auxiliar_lp, int m, int auxiliar_n, int* base);
+double** add_bound_row(double** matrix, int m, int n, int column, double sign, double bound);
 
 int is_b_negative(double** matrix, int m, int n);
 void make_b_non_negative(double** matrix, int m, int n);
 int is_c_positive(double** matrix, int m, int n);
 
+int is_cancelled(atomic_int* cancel);
+
 void set_initial_base(double** matrix, int m, int n, int* base);
 
-int find_non_zero_element(double** matrix, int m, int column);
+int find_non_zero_element(double** matrix, int m, int column, int from_row);
 void format_canonical(double** matrix, int m, int n, int* base);
-int primal_next_base(double** matrix, int m, int n, int* base_row, int* base_column);
-int primal_simplex(double** matrix, int m, int n, int* base, int print_output);
-int dual_next_base(double** matrix, int m, int n, int* base_row, int* base_column);
-int dual_simplex(double** matrix, int m, int n, int* base, int print_output);
+int primal_next_base(double** matrix, int m, int n, int* base, int* base_row, int* base_column);
+int primal_simplex(double** matrix, int m, int n, int* base, int print_output, atomic_int* cancel);
+int dual_next_base(double** matrix, int m, int n, int* base, int* base_row, int* base_column);
+int shift_costs(double** matrix, int m, int n, double* shift);
+void unshift_costs(double** matrix, int m, int n, int* base, double* shift);
+int dual_simplex(double** matrix, int m, int n, int* base, int print_output, atomic_int* cancel);
 
 double* get_primal_optimal_solution(double** matrix, int m, int n, int* base);
 double* get_dual_optimal_solution(double** matrix, int m);
 double* generate_unboundedness_certificate(double** matrix, int m, int n, int column, int* base);
+double* generate_infeasibility_certificate(double** matrix, int m, int n);
 
 #endif
\ No newline at end of file
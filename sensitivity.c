@@ -0,0 +1,244 @@
+/* Sensitivity Analysis
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "lalgebra.h"
+#include "sensitivity.h"
+
+// Constant to solve floating point comparisons
+#define EPSILON 0.000001
+
+// Stops the parametric analysis if the LP keeps changing base, which only happens when it cycles
+#define MAX_BREAKPOINTS 1000
+
+/***** RANGING ******/
+
+// How much each b_k can increase or decrease before the base stops being feasible. Changing b_k by delta
+// changes the basic variables by delta times column k of the operations register
+void b_ranging(double** matrix, int m, int n, double* increase, double* decrease) {
+  int i, k;
+
+  for(k = 0; k < (m - 1); k++) {
+    increase[k] = INFINITY;
+    decrease[k] = INFINITY;
+    for(i = 1; i < m; i++) {
+      if(matrix[i][k] < 0 && (matrix[i][n - 1] / (-1 * matrix[i][k])) < increase[k]) {
+        increase[k] = matrix[i][n - 1] / (-1 * matrix[i][k]);
+      }
+      if(matrix[i][k] > 0 && (matrix[i][n - 1] / matrix[i][k]) < decrease[k]) {
+        decrease[k] = matrix[i][n - 1] / matrix[i][k];
+      }
+    }
+  }
+}
+
+// How much each c_j can increase or decrease before the base stops being optimal. For a variable out of the
+// base only its own reduced cost changes. For a basic variable every reduced cost changes by delta times
+// the row of the variable, and the first one to reach zero limits delta
+void c_ranging(double** matrix, int m, int n, int* base, double* increase, double* decrease) {
+  int i, j, k, row;
+
+  for(j = 0; j < (n - 1 - (m - 1) - (m - 1)); j++) {
+    row = 0;
+    for(i = 0; i < (m - 1); i++) {
+      if(base[i] == (j + (m - 1))) {
+        row = i + 1;
+      }
+    }
+
+    if(row == 0) { // Not in the base
+      increase[j] = matrix[0][j + (m - 1)];
+      decrease[j] = INFINITY;
+      continue;
+    }
+
+    increase[j] = INFINITY;
+    decrease[j] = INFINITY;
+    for(k = (m - 1); k < (n - 1); k++) { // Skips the operation register columns
+      if(k == (j + (m - 1))) {
+        continue;
+      }
+      if(matrix[row][k] < 0 && (matrix[0][k] / (-1 * matrix[row][k])) < increase[j]) {
+        increase[j] = matrix[0][k] / (-1 * matrix[row][k]);
+      }
+      if(matrix[row][k] > 0 && (matrix[0][k] / matrix[row][k]) < decrease[j]) {
+        decrease[j] = matrix[0][k] / matrix[row][k];
+      }
+    }
+  }
+}
+
+/***** PARAMETRIC ANALYSIS ******/
+
+// Prints x(theta) = x + theta * dx, which is how the solution varies inside one interval of theta
+static void print_parametric_solution(double** matrix, int m, int n, int* base, double* slope, double theta) {
+  double* solution;
+  double* direction;
+  int i, variables;
+
+  variables = n - 1 - (m - 1) - (m - 1);
+  solution = get_primal_optimal_solution(matrix, m, n, base);
+  direction = calloc((n - 1 - (m - 1)), sizeof(double));
+
+  for(i = 0; i < (m - 1); i++) {
+    direction[base[i] - (m - 1)] = slope[i + 1];
+    solution[base[i] - (m - 1)] -= theta * slope[i + 1];
+  }
+
+  printf("x = ");
+  print_output_vector(solution, variables);
+  printf(" + theta * ");
+  print_output_vector(direction, variables);
+
+  free(solution);
+  free(direction);
+}
+
+// Walks b + theta * direction from theta = 0 while the LP stays feasible. Inside each interval the base is the
+// same and the solution moves along the register times direction. When a basic variable reaches zero it leaves
+// the base with a pivot of the dual simplex. matrix and base must hold an optimal tableau
+void parametric_b(double** matrix, int m, int n, int* base, double* direction) {
+  double* slope;
+  double theta, step, ratio;
+  int i, k, j, row, column, breakpoints;
+
+  slope = malloc(m * sizeof(double));
+  theta = 0;
+
+  for(breakpoints = 0; breakpoints < MAX_BREAKPOINTS; breakpoints++) {
+    // Derivative of the last column: basic variables in the rows and objective value in the first one
+    for(i = 0; i < m; i++) {
+      slope[i] = 0;
+      for(k = 0; k < (m - 1); k++) {
+        slope[i] += matrix[i][k] * direction[k];
+      }
+    }
+
+    step = INFINITY;
+    row = 0;
+    for(i = 1; i < m; i++) {
+      if(slope[i] < -EPSILON && (matrix[i][n - 1] / (-1 * slope[i])) < step) {
+        step = matrix[i][n - 1] / (-1 * slope[i]);
+        row = i;
+      }
+    }
+
+    printf("theta em [%g, %g]: ", round(theta * 100000) / 100000, round((theta + step) * 100000) / 100000);
+    print_parametric_solution(matrix, m, n, base, slope, theta);
+    printf(", com valor objetivo %g + theta * %g\n", round((matrix[0][n - 1] - theta * slope[0]) * 100000) / 100000,
+      round(slope[0] * 100000) / 100000);
+
+    if(row == 0) { // Base is feasible for every theta from here on
+      break;
+    }
+
+    theta += step;
+    for(i = 0; i < m; i++) {
+      matrix[i][n - 1] += step * slope[i];
+      if(fabs(matrix[i][n - 1]) < EPSILON) {
+        matrix[i][n - 1] = 0;
+      }
+    }
+
+    // Dual simplex ratio test in the row that is about to become negative
+    column = 0;
+    ratio = INFINITY;
+    for(j = (m - 1); j < (n - 1); j++) {
+      if(matrix[row][j] < 0 && (matrix[0][j] / (-1 * matrix[row][j])) < ratio) {
+        ratio = matrix[0][j] / (-1 * matrix[row][j]);
+        column = j;
+      }
+    }
+
+    if(column == 0) {
+      printf("PL inviável para theta > %g\n", round(theta * 100000) / 100000);
+      break;
+    }
+
+    base[row - 1] = column;
+    format_canonical(matrix, m, n, base);
+  }
+
+  free(slope);
+}
+
+// Walks c + theta * direction from theta = 0 while the LP stays bounded. Inside each interval the solution is
+// the same and the reduced costs move along slope. When a reduced cost reaches zero its column enters the base
+// with a pivot of the primal simplex. matrix and base must hold an optimal tableau
+void parametric_c(double** matrix, int m, int n, int* base, double* direction) {
+  double* slope;
+  double* solution;
+  double theta, step, ratio;
+  int i, j, row, column, breakpoints;
+
+  slope = malloc(n * sizeof(double));
+  theta = 0;
+
+  for(breakpoints = 0; breakpoints < MAX_BREAKPOINTS; breakpoints++) {
+    // The first row holds -c plus multiples of the other rows. The basic variables add their rows again
+    for(j = 0; j < n; j++) {
+      slope[j] = 0;
+      if(j >= (m - 1) && j < (n - 1 - (m - 1))) {
+        slope[j] = -1 * direction[j - (m - 1)];
+      }
+    }
+    for(i = 0; i < (m - 1); i++) {
+      if(base[i] < (n - 1 - (m - 1))) { // Slacks have no cost
+        for(j = 0; j < n; j++) {
+          slope[j] += direction[base[i] - (m - 1)] * matrix[i + 1][j];
+        }
+      }
+    }
+
+    step = INFINITY;
+    column = 0;
+    for(j = (m - 1); j < (n - 1); j++) {
+      if(slope[j] < -EPSILON && (matrix[0][j] / (-1 * slope[j])) < step) {
+        step = matrix[0][j] / (-1 * slope[j]);
+        column = j;
+      }
+    }
+
+    solution = get_primal_optimal_solution(matrix, m, n, base);
+    printf("theta em [%g, %g]: x = ", round(theta * 100000) / 100000, round((theta + step) * 100000) / 100000);
+    print_output_vector(solution, (n - 1 - (m - 1) - (m - 1)));
+    free(solution);
+    printf(", com valor objetivo %g + theta * %g\n", round((matrix[0][n - 1] - theta * slope[n - 1]) * 100000) / 100000,
+      round(slope[n - 1] * 100000) / 100000);
+
+    if(column == 0) { // Base is optimal for every theta from here on
+      break;
+    }
+
+    theta += step;
+    for(j = 0; j < n; j++) {
+      matrix[0][j] += step * slope[j];
+      if(fabs(matrix[0][j]) < EPSILON) {
+        matrix[0][j] = 0;
+      }
+    }
+
+    // Primal simplex ratio test in the column that is about to become negative
+    row = 0;
+    ratio = INFINITY;
+    for(i = 1; i < m; i++) {
+      if(matrix[i][column] > 0 && (matrix[i][n - 1] / matrix[i][column]) < ratio) {
+        ratio = matrix[i][n - 1] / matrix[i][column];
+        row = i;
+      }
+    }
+
+    if(row == 0) {
+      printf("PL ilimitada para theta > %g\n", round(theta * 100000) / 100000);
+      break;
+    }
+
+    base[row - 1] = column;
+    format_canonical(matrix, m, n, base);
+  }
+
+  free(slope);
+}
@@ -0,0 +1,15 @@
+/* Sensitivity Analysis
+ */
+
+#ifndef __SENSITIVITY_HEADER__
+#define __SENSITIVITY_HEADER__
+
+/***** RANGING ******/
+void b_ranging(double** matrix, int m, int n, double* increase, double* decrease);
+void c_ranging(double** matrix, int m, int n, int* base, double* increase, double* decrease);
+
+/***** PARAMETRIC ANALYSIS ******/
+void parametric_b(double** matrix, int m, int n, int* base, double* direction);
+void parametric_c(double** matrix, int m, int n, int* base, double* direction);
+
+#endif
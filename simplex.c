@@ -9,6 +9,80 @@
 #include <ctype.h>
 
 #include "lalgebra.h"
+#include "interior.h"
+#include "concurrent.h"
+#include "branch.h"
+#include "sensitivity.h"
+#include "cache.h"
+#include "small.h"
+
+// Extracts the final answer from the tableau. result is the return value of the simplex and certificate
+// is the certificate of infeasibility, used only when result == (n - 1)
+struct lp_result* extract_result(double** lp, int m, int n, int* base, int result, double* certificate) {
+  struct lp_result* answer;
+  int i;
+
+  answer = malloc(sizeof(struct lp_result));
+  answer->variables = n - 1 - (m - 1) - (m - 1);
+  answer->restrictions = m - 1;
+  answer->value = 0;
+  answer->base = NULL;
+
+  if(result == (n - 1)) { // LP is infeasible
+    answer->status = 'I';
+    answer->x = NULL;
+    answer->y = malloc((m - 1) * sizeof(double));
+    for(i = 0; i < (m - 1); i++) {
+      answer->y[i] = certificate[i];
+    }
+  }
+  else if(result > 0) { // LP is unbounded
+    answer->status = 'U';
+    answer->x = generate_unboundedness_certificate(lp, m, n, result, base);
+    answer->y = NULL;
+  } 
+  else { // LP is optimal
+    answer->status = 'O';
+    answer->value = lp[0][n - 1];
+    answer->x = get_primal_optimal_solution(lp, m, n, base);
+    answer->y = get_dual_optimal_solution(lp, m);
+    answer->base = malloc((m - 1) * sizeof(int));
+    for(i = 0; i < (m - 1); i++) {
+      answer->base[i] = base[i];
+    }
+  }
+
+  return answer;
+}
+
+// Prints the final answer for the modes that don't print the tableaus
+void print_lp_result(struct lp_result* answer) {
+  if(answer->status == 'I') {
+    printf("PL inviável, aqui está um certificado ");
+    print_output_vector(answer->y, answer->restrictions);
+    printf("\n");
+  }
+  else if(answer->status == 'U') {
+    printf("PL ilimitada, aqui está um certificado ");
+    print_output_vector(answer->x, answer->variables);
+    printf("\n");
+  } 
+  else {
+    printf("Solução ótima x = ");
+    print_output_vector(answer->x, answer->variables);
+    printf(", com valor objetivo %g, e solução dual y = ", round(answer->value * 100000) / 100000);
+    print_output_vector(answer->y, answer->restrictions);
+    printf("\n");
+  }
+}
+
+void print_result(double** lp, int m, int n, int* base, int result, double* certificate) {
+  struct lp_result* answer;
+
+  answer = extract_result(lp, m, n, base, result, certificate);
+  print_lp_result(answer);
+  free_lp_result(answer);
+}
 
 int main(int argc, char* argv[]) {
   // Linear Programming represented as a matrix similar to the tableau
@@ -17,6 +91,9 @@ int main(int argc, char* argv[]) {
   // Auxiliar LP built upon the original LP
   double** auxiliar_lp;
 
+  // Winner of the race between the solvers in mode 3
+  struct solver_run* run;
+
   // Bases are column numbers ordered by rows. If a column contains the base for the first 
   // restriction(first row of A), it is going to be on the first index of base and so forth
   int* base; 
@@ -25,11 +102,36 @@ int main(int argc, char* argv[]) {
   // mode is the mode chosen by the user. simplex_result is the return value of the simplex algorithms
   int m, n, auxiliar_n, mode, simplex_result;
 
-  // User choice for primal or dual simplex in mode 2
+  // User choice for primal or dual simplex in mode 2, for the node selection in mode 5 and for
+  // the kind of sensitivity analysis in mode 6
   char simplex_type; 
 
+  // Integer variables marked in the input for mode 5, the best integer solution and its value
+  double** integer_input;
+  int* integer;
+  double* integer_solution;
+  double integer_value;
+  int i;
+
+  // Cache given as the second argument, used by modes 1, 3 and 4. The answer of these modes is kept in
+  // answer, and cached or warm_base are set when the same LP or the same A is found in the cache
+  char* cache_file;
+  struct cache_entry* cache;
+  struct lp_result* answer;
+  struct lp_result* cached;
+  int* warm_base;
+  struct lp_key key;
+
+  // Certificate of infeasibility given by the small LP kernels in mode 1
+  double* certificate;
+
+  // Ranging and parametric direction in mode 6
+  double** direction;
+  double* increase;
+  double* decrease;
+
   // Receive and discard the string "modo". We make this to facilitate the parsing
-  char string_modo[4];
+  char string_modo[5];
 
   // Input file
   FILE* input; 
@@ -43,8 +145,8 @@ int main(int argc, char* argv[]) {
   // Gets the modus operandi
   fscanf(input, "%s %d", string_modo, &mode);
 
-  // Primal or dual simplex
-  if(mode == 2) { 
+  // Primal or dual simplex, best first or depth first search, or ranging or parametric analysis
+  if(mode == 2 || mode == 5 || mode == 6) { 
     fscanf(input, " %c", &simplex_type); 
   }
 
@@ -54,6 +156,15 @@ int main(int argc, char* argv[]) {
   lp = allocate_matrix(m, n); // Allocate memory for matrix of dimensions m x n
   parse_input(input, lp, m, n); // Fill the allocated matrix with the input
 
+  // The hashes are taken before the LP is formatted, so they only depend on what was read
+  cache_file = NULL;
+  cache = NULL;
+  if(argc >= 3 && (mode == 1 || mode == 3 || mode == 4)) {
+    cache_file = argv[2];
+    hash_lp(lp, m, n, mode, &key);
+    cache = load_cache(cache_file, &key);
+  }
+
   lp = format_sef(lp, m, n); // Adds the slack variables for the problem by formating it to the standard equalities form   
   n += m - 1; // (m - 1) columns were added to the matrix
 
@@ -66,78 +177,223 @@ int main(int argc, char* argv[]) {
   // Base will always be a vector with (m - 1) columns because this is the rank of the matrix
   base = malloc((m - 1) * sizeof(int)); 
 
-  switch(mode) {
-    case 1:
-      auxiliar_lp = create_auxiliar_lp(lp, m, n); 
-      auxiliar_n = n + m - 1; // Auxiliar LP creates (m - 1) new columns in A
+  cached = NULL;
+  warm_base = NULL;
+  answer = NULL;
+  if(cache != NULL) {
+    cached = find_result(cache, &key);
+    warm_base = find_base(cache, &key);
+  }
 
-      set_initial_base(auxiliar_lp, m, auxiliar_n, base); // Set the initial base for the auxiliar LP
+  if(cached != NULL) { // Same LP was already solved by this mode
+    print_lp_result(cached);
+  }
+  else if(warm_base != NULL) { // Same A was already solved, so its optimal base is a good start for the new b and c
+    for(i = 0; i < (m - 1); i++) {
+      base[i] = warm_base[i];
+    }
+    simplex_result = dual_simplex(lp, m, n, base, 0, NULL);
+    if(simplex_result == (n - 1)) { // LP is infeasible
+      answer = extract_result(lp, m, n, base, simplex_result, generate_infeasibility_certificate(lp, m, n));
+    }
+    else {
+      answer = extract_result(lp, m, n, base, simplex_result, NULL);
+    }
+  }
+  else {
+    switch(mode) {
+      case 1:
+        simplex_result = -2;
+        if(is_small_lp(m, n)) { // Small LPs are solved on the stack by the kernel made for their size
+          certificate = malloc((m - 1) * sizeof(double));
+          simplex_result = small_simplex(lp, m, n, base, certificate);
+          if(simplex_result != -2) {
+            answer = extract_result(lp, m, n, base, simplex_result, certificate);
+          }
+          free(certificate);
+        }
 
-      primal_simplex(auxiliar_lp, m, auxiliar_n, base, 0); // Runs simplex for Auxiliar LP but doesn't print the output
+        if(simplex_result == -2) { // The LP is too big for the kernels or they couldn't solve it
+          auxiliar_lp = create_auxiliar_lp(lp, m, n); 
+          auxiliar_n = n + m - 1; // Auxiliar LP creates (m - 1) new columns in A
 
-      if(auxiliar_lp[0][auxiliar_n - 1] < 0) { // LP is infeasible
-        printf("PL inviável, aqui está um certificado ");
-        // The optimal solution for the dual of the auxiliar LP is a certificate of infeasibility for the original LP
-        print_output_vector(get_dual_optimal_solution(auxiliar_lp, m), m - 1);
-        printf("\n");
-      }
-      else {
-        // The base now is the final base of the auxiliar LP, which is a good one to begin the simplex with
-        simplex_result = primal_simplex(lp, m, n, base, 0);
+          set_initial_base(auxiliar_lp, m, auxiliar_n, base); // Set the initial base for the auxiliar LP
 
-        if(simplex_result > 0) { // LP is unbounded
-          printf("PL ilimitada, aqui está um certificado ");
-          print_output_vector(generate_unboundedness_certificate(lp, m, n, simplex_result, base), (n - 1 - (m - 1) - (m - 1)));
-          printf("\n");
-        } 
-        else { // LP is optimal
-          printf("Solução ótima x = ");
-          print_output_vector(get_primal_optimal_solution(lp, m, n, base), (n - 1 - (m - 1) - (m - 1)));
-          printf(", com valor objetivo %g, e solução dual y = ", round(lp[0][n - 1] * 100000) / 100000);
-          print_output_vector(get_dual_optimal_solution(lp, m), m - 1);
-          printf("\n");
-        }
-      }
-    break;
-
-    case 2:
-
-      switch(simplex_type) {
-        case 'P':
-          // If b has some negative entry, use auxiliar LP to find a good base of columns to start the simplex with
-          if(is_b_negative(lp, m, n)) { 
-            auxiliar_lp = create_auxiliar_lp(lp, m, n);
-            auxiliar_n = n + m - 1;
-            set_initial_base(auxiliar_lp, m, auxiliar_n, base);
-            primal_simplex(auxiliar_lp, m, auxiliar_n, base, 0);
+          primal_simplex(auxiliar_lp, m, auxiliar_n, base, 0, NULL); // Runs simplex for Auxiliar LP but doesn't print the output
+
+          if(auxiliar_lp[0][auxiliar_n - 1] < 0) { // LP is infeasible
+            // The optimal solution for the dual of the auxiliar LP is a certificate of infeasibility for the original LP
+            answer = extract_result(lp, m, n, base, (n - 1), get_dual_optimal_solution(auxiliar_lp, m));
           }
           else {
-            // Set base columns to the slack variables
-            set_initial_base(lp, m, n, base);
+            // The base now is the final base of the auxiliar LP, which is a good one to begin the simplex with
+            remove_artificial_base(auxiliar_lp, m, auxiliar_n, base);
+            simplex_result = primal_simplex(lp, m, n, base, 0, NULL);
+            answer = extract_result(lp, m, n, base, simplex_result, NULL);
           }
+        }
+      break;
+
+      case 2:
+
+        switch(simplex_type) {
+          case 'P':
+            // If b has some negative entry, use auxiliar LP to find a good base of columns to start the simplex with
+            if(is_b_negative(lp, m, n)) { 
+              auxiliar_lp = create_auxiliar_lp(lp, m, n);
+              auxiliar_n = n + m - 1;
+              set_initial_base(auxiliar_lp, m, auxiliar_n, base);
+              primal_simplex(auxiliar_lp, m, auxiliar_n, base, 0, NULL);
+              remove_artificial_base(auxiliar_lp, m, auxiliar_n, base);
+            }
+            else {
+              // Set base columns to the slack variables
+              set_initial_base(lp, m, n, base);
+            }
 
-          simplex_result = primal_simplex(lp, m, n, base, 1);
-        break;
+            simplex_result = primal_simplex(lp, m, n, base, 1, NULL);
+          break;
 
-        case 'D':
-          // We can only run the dual simplex if we have a positive c vector in the tableau.
-          // That is not entirely true, but for the scope of this assignment it will
-          if(is_c_positive(lp, m, n)) {
+          case 'D':
+            // Costs that are not positive are handled by the dual phase one inside the dual simplex
             set_initial_base(lp, m, n, base);
-            simplex_result = dual_simplex(lp, m, n, base, 1);
+            simplex_result = dual_simplex(lp, m, n, base, 1, NULL);
+          break;
+
+          default:
+          printf("Erro: Opção Inválida.\n");
+        }
+      break;
+
+      case 3:
+        // Primal simplex, dual simplex and interior point race on copies of the LP and the first one to finish gives the answer
+        run = concurrent_simplex(lp, m, n);
+        answer = extract_result(run->lp, m, n, run->base, run->result, run->certificate);
+        free_solver_run(run);
+      break;
+
+      case 4:
+        // Interior point method with crossover to a base, so the answer has the same format as mode 1
+        simplex_result = interior_point(lp, m, n, base, NULL);
+        if(simplex_result == (n - 1)) { // LP is infeasible
+          answer = extract_result(lp, m, n, base, simplex_result, generate_infeasibility_certificate(lp, m, n));
+        }
+        else {
+          answer = extract_result(lp, m, n, base, simplex_result, NULL);
+        }
+      break;
+
+      case 5:
+        // Best first (M) or depth first (P) search of the branch and bound tree
+        if(simplex_type != 'M' && simplex_type != 'P') {
+          printf("Erro: Opção Inválida.\n");
+          break;
+        }
+
+        // The line after the LP marks with 1 the variables that must be integer
+        integer_input = allocate_matrix(1, (n - 1 - (m - 1) - (m - 1)));
+        parse_input(input, integer_input, 1, (n - 1 - (m - 1) - (m - 1)));
+        integer = malloc((n - 1 - (m - 1) - (m - 1)) * sizeof(int));
+        for(i = 0; i < (n - 1 - (m - 1) - (m - 1)); i++) {
+          integer[i] = (integer_input[0][i] != 0);
+        }
+        free_matrix(integer_input, 1);
+
+        // The LP relaxation is the root of the branch and bound. If it is not optimal neither is the integer LP
+        set_initial_base(lp, m, n, base);
+        simplex_result = dual_simplex(lp, m, n, base, 0, NULL);
+
+        if(simplex_result == (n - 1)) { // LP is infeasible
+          print_result(lp, m, n, base, simplex_result, generate_infeasibility_certificate(lp, m, n));
+        }
+        else if(simplex_result > 0) { // LP is unbounded
+          print_result(lp, m, n, base, simplex_result, NULL);
+        }
+        else {
+          integer_solution = malloc((n - 1 - (m - 1) - (m - 1)) * sizeof(double));
+          if(branch_and_bound(lp, m, n, base, integer, simplex_type, &integer_value, integer_solution)) {
+            printf("Solução ótima inteira x = ");
+            print_output_vector(integer_solution, (n - 1 - (m - 1) - (m - 1)));
+            printf(", com valor objetivo %g\n", round(integer_value * 100000) / 100000);
           }
           else {
-            printf("Não foi possível rodar o simplex dual com a PL dada.\n");
+            printf("PL inteira inviável\n");
           }
-        break;
+          free(integer_solution);
+        }
+        free(integer);
+      break;
 
-        default:
-        printf("Erro: Opção Inválida.\n");
-      }
-    break;
+      case 6:
+        set_initial_base(lp, m, n, base);
+        simplex_result = dual_simplex(lp, m, n, base, 0, NULL);
+
+        if(simplex_result == (n - 1)) { // LP is infeasible
+          print_result(lp, m, n, base, simplex_result, generate_infeasibility_certificate(lp, m, n));
+          break;
+        }
+
+        print_result(lp, m, n, base, simplex_result, NULL);
+        if(simplex_result > 0) { // LP is unbounded
+          break;
+        }
+
+        switch(simplex_type) {
+          case 'S':
+            // Ranging comes straight from the final tableau, without solving the LP again
+            increase = malloc((n - 1 - (m - 1)) * sizeof(double));
+            decrease = malloc((n - 1 - (m - 1)) * sizeof(double));
+
+            b_ranging(lp, m, n, increase, decrease);
+            printf("Aumento permitido em b = ");
+            print_output_vector(increase, m - 1);
+            printf(", redução permitida em b = ");
+            print_output_vector(decrease, m - 1);
+            printf("\n");
+
+            c_ranging(lp, m, n, base, increase, decrease);
+            printf("Aumento permitido em c = ");
+            print_output_vector(increase, (n - 1 - (m - 1) - (m - 1)));
+            printf(", redução permitida em c = ");
+            print_output_vector(decrease, (n - 1 - (m - 1) - (m - 1)));
+            printf("\n");
+
+            free(increase);
+            free(decrease);
+          break;
+
+          case 'B':
+            // The line after the LP is the direction in which b moves
+            direction = allocate_matrix(1, m - 1);
+            parse_input(input, direction, 1, m - 1);
+            parametric_b(lp, m, n, base, direction[0]);
+            free_matrix(direction, 1);
+          break;
+
+          case 'C':
+            // The line after the LP is the direction in which c moves
+            direction = allocate_matrix(1, (n - 1 - (m - 1) - (m - 1)));
+            parse_input(input, direction, 1, (n - 1 - (m - 1) - (m - 1)));
+            parametric_c(lp, m, n, base, direction[0]);
+            free_matrix(direction, 1);
+          break;
+
+          default:
+          printf("Erro: Opção Inválida.\n");
+        }
+      break;
+
+      default:
+      printf("Erro: Opção Inválida.\n");
+    }
+  }
 
-    default:
-    printf("Erro: Opção Inválida.\n");
+  if(answer != NULL) { // Modes 1, 3 and 4 print their answer here so it can be saved in the cache
+    print_lp_result(answer);
+    if(cache_file != NULL) {
+      save_result(cache_file, &key, answer);
+    }
+    free_lp_result(answer);
   }
 
   fclose(input);
@@ -147,6 +403,7 @@ int main(int argc, char* argv[]) {
   if(auxiliar_lp != NULL) { // If it was used to solve the LP, we need to free it
     free(auxiliar_lp); 
   }
+  free_cache(cache);
 
   return 0;
 }
\ No newline at end of file
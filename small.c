@@ -0,0 +1,281 @@
+/* Small LP Solver
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "small.h"
+
+// Constant to solve floating point comparisons
+#define EPSILON 0.000001
+
+// Number of kernel sizes
+#define NUM_KERNELS 3
+
+// Rows of the tableau are the objective, one for each restriction and the objective of the auxiliar LP. The
+// columns are the operations register, the variables, the slacks, the artificial variables, b and 3 zeros
+// that make the length a multiple of 4, so the pivot can go through 4 columns at a time
+#define SMALL_ROWS(SIZE) ((SIZE) + 2)
+#define SMALL_COLUMNS(SIZE) (4 * (SIZE) + 4)
+#define SMALL_B(SIZE) (4 * (SIZE))
+
+// Same as the operations on rows of the general solver, values this small are treated as 0
+static inline double snap(double value) {
+  return (fabs(value) < EPSILON) ? 0 : value;
+}
+
+/***** KERNELS ******/
+
+// Defines the kernels for tableaus of the given size. Every loop bound is a constant, so the compiler can
+// unroll them and keep the rows in registers. Padding columns and rows of unused restrictions hold zeros and
+// never enter or leave the base
+#define DEFINE_SMALL_KERNELS(SIZE)                                                                       \
+                                                                                                         \
+/* Makes the column basic in the row, with the same operations the general solver uses */                \
+static void small_pivot_##SIZE(double* tableau, int row, int column) {                                   \
+  double* pivot_row;                                                                                     \
+  double* other_row;                                                                                     \
+  double multiply_by;                                                                                    \
+  int i, j;                                                                                              \
+                                                                                                         \
+  pivot_row = tableau + row * SMALL_COLUMNS(SIZE);                                                       \
+  multiply_by = snap(1 / pivot_row[column]);                                                             \
+  for(j = 0; j < SMALL_COLUMNS(SIZE); j += 4) {                                                          \
+    pivot_row[j] = snap(pivot_row[j] * multiply_by);                                                     \
+    pivot_row[j + 1] = snap(pivot_row[j + 1] * multiply_by);                                             \
+    pivot_row[j + 2] = snap(pivot_row[j + 2] * multiply_by);                                             \
+    pivot_row[j + 3] = snap(pivot_row[j + 3] * multiply_by);                                             \
+  }                                                                                                      \
+                                                                                                         \
+  for(i = 0; i < SMALL_ROWS(SIZE); i++) {                                                                \
+    other_row = tableau + i * SMALL_COLUMNS(SIZE);                                                       \
+    multiply_by = snap(-1 * other_row[column]);                                                          \
+    if(i == row || multiply_by == 0) {                                                                   \
+      continue;                                                                                          \
+    }                                                                                                    \
+    for(j = 0; j < SMALL_COLUMNS(SIZE); j += 4) {                                                        \
+      other_row[j] = snap(other_row[j] + pivot_row[j] * multiply_by);                                    \
+      other_row[j + 1] = snap(other_row[j + 1] + pivot_row[j + 1] * multiply_by);                        \
+      other_row[j + 2] = snap(other_row[j + 2] + pivot_row[j + 2] * multiply_by);                        \
+      other_row[j + 3] = snap(other_row[j + 3] + pivot_row[j + 3] * multiply_by);                        \
+    }                                                                                                    \
+  }                                                                                                      \
+}                                                                                                        \
+                                                                                                         \
+/* First column before last_column with a negative cost (Bland's Rule), or 0 if there is none. */        \
+/* Goes from the last column to the first one so the choice is a select instead of a branch */           \
+static int small_entering_##SIZE(double* tableau, int cost_row, int last_column) {                       \
+  double* cost;                                                                                          \
+  int j, column;                                                                                         \
+                                                                                                         \
+  cost = tableau + cost_row * SMALL_COLUMNS(SIZE);                                                       \
+  column = 0;                                                                                            \
+  for(j = (SMALL_B(SIZE) - 1); j >= (SIZE); j--) { /* Skips the operation register columns */            \
+    column = ((cost[j] < 0) & (j < last_column)) ? j : column;                                           \
+  }                                                                                                      \
+                                                                                                         \
+  return column;                                                                                         \
+}                                                                                                        \
+                                                                                                         \
+/* Row with the minimum ratio in the column, or 0 if the LP is unbounded. Ties go to the row whose */    \
+/* basic column has the smallest index, like in the general solver. Rows with a non positive element */  \
+/* are masked out instead of skipped */                                                                  \
+static int small_leaving_##SIZE(double* tableau, int* base, int column) {                                \
+  double element, ratio, min_ratio;                                                                      \
+  int i, row, valid;                                                                                     \
+                                                                                                         \
+  min_ratio = 999999;                                                                                    \
+  for(i = 1; i <= (SIZE); i++) {                                                                         \
+    element = tableau[i * SMALL_COLUMNS(SIZE) + column];                                                 \
+    ratio = tableau[i * SMALL_COLUMNS(SIZE) + SMALL_B(SIZE)] / ((element > 0) ? element : 1);            \
+    valid = (element > 0) & (ratio < min_ratio);                                                         \
+    min_ratio = valid ? ratio : min_ratio;                                                               \
+  }                                                                                                      \
+                                                                                                         \
+  row = 0;                                                                                               \
+  for(i = 1; i <= (SIZE); i++) {                                                                         \
+    element = tableau[i * SMALL_COLUMNS(SIZE) + column];                                                 \
+    ratio = tableau[i * SMALL_COLUMNS(SIZE) + SMALL_B(SIZE)] / ((element > 0) ? element : 1);            \
+    valid = (element > 0) & (ratio <= (min_ratio + EPSILON));                                            \
+    valid = valid & ((row == 0) || (base[i - 1] < base[row - 1]));                                       \
+    row = valid ? i : row;                                                                               \
+  }                                                                                                      \
+                                                                                                         \
+  return row;                                                                                            \
+}
+
+#define SMALL_KERNEL(SIZE) {SIZE, SMALL_COLUMNS(SIZE), small_pivot_##SIZE, small_entering_##SIZE, small_leaving_##SIZE}
+
+DEFINE_SMALL_KERNELS(4)
+DEFINE_SMALL_KERNELS(8)
+DEFINE_SMALL_KERNELS(16)
+
+// Ordered by size, so the first one that fits is the smallest
+static struct small_kernel kernels[NUM_KERNELS] = {
+  SMALL_KERNEL(4),
+  SMALL_KERNEL(8),
+  SMALL_KERNEL(16)
+};
+
+/***** SOLVER ******/
+
+// Column of the kernel's tableau that holds column j of the LP
+static int kernel_column(struct small_kernel* kernel, int m, int n, int j) {
+  int variables;
+
+  variables = n - 1 - (m - 1) - (m - 1);
+
+  if(j < (m - 1)) { // Operations register
+    return j;
+  }
+  if(j < ((m - 1) + variables)) { // Variables
+    return kernel->size + j - (m - 1);
+  }
+  if(j < (n - 1)) { // Slacks
+    return 2 * kernel->size + j - (m - 1) - variables;
+  }
+
+  return SMALL_B(kernel->size);
+}
+
+// Column of the LP held by the given column of the kernel's tableau. Artificial variables have none
+static int lp_column(struct small_kernel* kernel, int m, int n, int column) {
+  int variables;
+
+  variables = n - 1 - (m - 1) - (m - 1);
+
+  if(column < kernel->size) {
+    return column;
+  }
+  if(column < (2 * kernel->size)) {
+    return column - kernel->size + (m - 1);
+  }
+
+  return column - 2 * kernel->size + (m - 1) + variables;
+}
+
+// Runs the simplex with the costs of cost_row until it is optimal(-1) or unbounded(column number). Columns from
+// last_column on never enter the base
+static int small_phase(struct small_kernel* kernel, double* tableau, int* base, int cost_row, int last_column) {
+  int row, column;
+
+  while(1) {
+    column = kernel->entering(tableau, cost_row, last_column);
+    if(column == 0) { // LP is optimal
+      return -1;
+    }
+
+    row = kernel->leaving(tableau, base, column);
+    if(row == 0) { // LP is unbounded
+      return column;
+    }
+
+    kernel->pivot(tableau, row, column);
+    base[row - 1] = column;
+  }
+}
+
+// The tableau of LPs with at most SMALL_MAX_SIZE restrictions and variables fits on the stack
+int is_small_lp(int m, int n) {
+  return (m - 1) <= SMALL_MAX_SIZE && (n - 1 - (m - 1) - (m - 1)) <= SMALL_MAX_SIZE;
+}
+
+// Same path as mode 1, with the auxiliar LP and the original one sharing a tableau on the stack: the artificial
+// variables take the columns after the slacks and the auxiliar objective takes the last row. lp and base receive
+// the final tableau and base, so the answer is extracted like in the other modes. certificate must have (m - 1)
+// elements and is only set when the LP is infeasible. Returns like primal_simplex, (n - 1) if the LP is
+// infeasible or -2 if an artificial variable can't leave the base, in which case the general solver must be used
+int small_simplex(double** lp, int m, int n, int* base, double* certificate) {
+  double tableau[SMALL_ROWS(SMALL_MAX_SIZE) * SMALL_COLUMNS(SMALL_MAX_SIZE)];
+  int small_base[SMALL_MAX_SIZE];
+  struct small_kernel* kernel;
+  double* row;
+  double* auxiliar_row;
+  int i, j, k, size, columns, result;
+
+  size = (m - 1);
+  if((n - 1 - (m - 1) - (m - 1)) > size) {
+    size = n - 1 - (m - 1) - (m - 1);
+  }
+  for(k = 0; kernels[k].size < size; k++);
+  kernel = &kernels[k];
+  columns = kernel->columns;
+
+  memset(tableau, 0, SMALL_ROWS(kernel->size) * columns * sizeof(double));
+
+  // The ratio test reads the base of the rows of unused restrictions too, so it can't be garbage
+  memset(small_base, 0, SMALL_MAX_SIZE * sizeof(int));
+
+  for(i = 0; i < m; i++) {
+    for(j = 0; j < n; j++) {
+      tableau[i * columns + kernel_column(kernel, m, n, j)] = lp[i][j];
+    }
+  }
+
+  // Rows with negative b are negated and every row gets its artificial variable as the base, like in
+  // create_auxiliar_lp. The auxiliar objective is the sum of the artificial variables, in the canonical form
+  auxiliar_row = tableau + (kernel->size + 1) * columns;
+  for(i = 1; i < m; i++) {
+    row = tableau + i * columns;
+    if(row[SMALL_B(kernel->size)] < 0) {
+      for(j = 0; j < columns; j++) {
+        row[j] = snap(-1 * row[j]);
+      }
+    }
+    row[3 * kernel->size + (i - 1)] = 1;
+    small_base[i - 1] = 3 * kernel->size + (i - 1);
+    auxiliar_row[3 * kernel->size + (i - 1)] = 1;
+  }
+  for(i = 1; i < m; i++) {
+    row = tableau + i * columns;
+    for(j = 0; j < columns; j++) {
+      auxiliar_row[j] = snap(auxiliar_row[j] - row[j]);
+    }
+  }
+
+  small_phase(kernel, tableau, small_base, (kernel->size + 1), SMALL_B(kernel->size));
+
+  if(auxiliar_row[SMALL_B(kernel->size)] < 0) { // LP is infeasible
+    // The optimal solution for the dual of the auxiliar LP is a certificate of infeasibility for the original LP
+    for(i = 0; i < (m - 1); i++) {
+      certificate[i] = auxiliar_row[i];
+    }
+    return n - 1;
+  }
+
+  // Artificial variables left in the base with value 0 are replaced like in remove_artificial_base
+  for(i = 0; i < (m - 1); i++) {
+    if(small_base[i] >= (3 * kernel->size)) {
+      row = tableau + (i + 1) * columns;
+      for(j = kernel->size; j < (3 * kernel->size); j++) {
+        if(fabs(row[j]) > EPSILON) {
+          kernel->pivot(tableau, (i + 1), j);
+          small_base[i] = j;
+          break;
+        }
+      }
+      if(small_base[i] >= (3 * kernel->size)) {
+        return -2;
+      }
+    }
+  }
+
+  result = small_phase(kernel, tableau, small_base, 0, (3 * kernel->size));
+
+  for(i = 0; i < m; i++) {
+    for(j = 0; j < n; j++) {
+      lp[i][j] = tableau[i * columns + kernel_column(kernel, m, n, j)];
+    }
+  }
+  for(i = 0; i < (m - 1); i++) {
+    base[i] = lp_column(kernel, m, n, small_base[i]);
+  }
+
+  if(result != -1) { // Column of the certificate of unboundedness
+    result = lp_column(kernel, m, n, result);
+  }
+
+  return result;
+}
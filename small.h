@@ -0,0 +1,23 @@
+/* Small LP Solver
+ */
+
+#ifndef __SMALL_HEADER__
+#define __SMALL_HEADER__
+
+// Largest number of restrictions and of variables solved by the kernels
+#define SMALL_MAX_SIZE 16
+
+// Kernels made for one size of tableau. The tableau is a single array kept on the stack, where every row has
+// size columns for the operations register, the variables, the slacks and the artificial variables, then b
+struct small_kernel {
+  int size; // Largest number of restrictions and of variables
+  int columns; // Length of each row of the tableau
+  void (*pivot)(double* tableau, int row, int column);
+  int (*entering)(double* tableau, int cost_row, int last_column);
+  int (*leaving)(double* tableau, int* base, int column);
+};
+
+int is_small_lp(int m, int n);
+int small_simplex(double** lp, int m, int n, int* base, double* certificate);
+
+#endif